@@ -0,0 +1,105 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+#include "Employee.h"
+#include "Parallel.h"
+#include "Payroll.h"
+
+// имена файлов *.bin в каталоге, по алфавиту
+bool listBinaryFiles(const std::string& directory, std::vector<std::string>& names) {
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "\\*.bin").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE) return GetLastError() == ERROR_FILE_NOT_FOUND;
+    do {
+        if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) names.push_back(data.cFileName);
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir == NULL) return false;
+    while (struct dirent* entry = readdir(dir)) {
+        size_t length = std::strlen(entry->d_name);
+        if (length > 4 && std::strcmp(entry->d_name + length - 4, ".bin") == 0) names.push_back(entry->d_name);
+    }
+    closedir(dir);
+#endif
+    std::sort(names.begin(), names.end());
+    return true;
+}
+
+struct BatchState {
+    std::vector<std::string> binFiles;
+    std::vector<std::string> reportFiles;
+    std::vector<char> failed;
+    double hourlyRate;
+    unsigned threads;
+};
+
+// Поток index обрабатывает файлы index, index + threads, ...; буфер отчета
+// и вектор записей выделяются один раз на поток, а не на файл.
+void batchTask(void* arg, size_t index) {
+    BatchState* state = static_cast<BatchState*>(arg);
+    ReportWriter writer(state->hourlyRate);
+    std::vector<Employee> employees;
+    for (size_t i = index; i < state->binFiles.size(); i += state->threads) {
+        state->failed[i] = !generateReport(state->binFiles[i].c_str(), state->reportFiles[i].c_str(),
+                                           writer, employees);
+    }
+}
+
+// Утилита BatchReporter строит отчеты по всем файлам *.bin каталога в одном процессе:
+// argv[1] – каталог, отчет для <имя>.bin записывается в <имя>.txt рядом с ним,
+// argv[2] – оплата за час работы,
+// --threads=N – число потоков (0 – по числу процессоров, по умолчанию).
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4 || (argc == 4 && std::strncmp(argv[3], "--threads=", 10) != 0)) {
+        std::cerr << "Usage: BatchReporter <directory> <hourly_rate> [--threads=N]" << std::endl;
+        return 1;
+    }
+    std::string directory = argv[1];
+    BatchState state;
+    state.hourlyRate = std::atof(argv[2]);
+    state.threads = argc == 4 ? static_cast<unsigned>(std::atoi(argv[3] + 10)) : 0;
+    if (state.threads == 0) state.threads = hardwareThreadCount();
+
+    std::vector<std::string> names;
+    if (!listBinaryFiles(directory, names)) {
+        std::cerr << "Ошибка чтения каталога " << directory << "." << std::endl;
+        return 1;
+    }
+#ifdef _WIN32
+    std::string prefix = directory + "\\";
+#else
+    std::string prefix = directory + "/";
+#endif
+    for (size_t i = 0; i < names.size(); i++) {
+        state.binFiles.push_back(prefix + names[i]);
+        state.reportFiles.push_back(prefix + names[i].substr(0, names[i].size() - 4) + ".txt");
+    }
+    state.failed.assign(names.size(), 0);
+    if (state.threads > names.size()) state.threads = names.size() > 0 ? static_cast<unsigned>(names.size()) : 1;
+
+    runParallel(state.threads, batchTask, &state);
+
+    size_t failures = 0;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (state.failed[i]) {
+            std::cerr << "Ошибка построения отчета по файлу " << state.binFiles[i] << "." << std::endl;
+            failures++;
+        }
+    }
+    std::cout << "Обработано файлов: " << names.size() - failures << ", с ошибками: " << failures << "." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,287 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Employee.h"
+#include "EmployeeFileView.h"
+#include "EmployeeAsyncIO.h"
+#include "EmployeeGenerator.h"
+#include "EmployeeSort.h"
+#include "PayrollGroups.h"
+#include "Report.h"
+#include "Stopwatch.h"
+
+// временные файлы замеров
+const char* const BENCH_BIN_FILE = "lab1_bench.tmp.bin";
+const char* const BENCH_REPORT_FILE = "lab1_bench.tmp.txt";
+
+struct BenchContext {
+    std::vector<Employee> source;   // исходные записи (перемешанные id)
+    std::vector<Employee> scratch;  // рабочая копия, которую замер может менять
+    unsigned threads;
+};
+
+// Замер: выполняет действие один раз и возвращает его время в секундах;
+// в bytes записывается объем обработанных данных.
+typedef double (*BenchBody)(BenchContext& context, uint64_t& bytes);
+
+double benchWrite(BenchContext& context, uint64_t& bytes) {
+    double start = nowSeconds();
+    bool ok = writeEmployeeRecords(BENCH_BIN_FILE, context.source);
+    double elapsed = nowSeconds() - start;
+    bytes = sizeof(EmployeeFileHeader) + context.source.size() * sizeof(Employee);
+    return ok ? elapsed : -1;
+}
+
+double benchRead(BenchContext& context, uint64_t& bytes) {
+    context.scratch.clear();
+    double start = nowSeconds();
+    bool ok = readEmployeeRecords(BENCH_BIN_FILE, context.scratch);
+    double elapsed = nowSeconds() - start;
+    bytes = context.scratch.size() * sizeof(Employee);
+    return ok && context.scratch.size() == context.source.size() ? elapsed : -1;
+}
+
+double benchLoad(BenchContext& context, uint64_t& bytes) {
+    context.scratch.clear();
+    double start = nowSeconds();
+    bool ok = loadEmployeeRecords(BENCH_BIN_FILE, context.scratch);
+    double elapsed = nowSeconds() - start;
+    bytes = context.scratch.size() * sizeof(Employee);
+    return ok && context.scratch.size() == context.source.size() ? elapsed : -1;
+}
+
+double benchReadAsync(BenchContext& context, uint64_t& bytes) {
+    context.scratch.clear();
+    double start = nowSeconds();
+    bool ok = readEmployeeRecordsAsync(BENCH_BIN_FILE, context.scratch);
+    double elapsed = nowSeconds() - start;
+    bytes = context.scratch.size() * sizeof(Employee);
+    return ok && context.scratch.size() == context.source.size() ? elapsed : -1;
+}
+
+double benchWriteAsync(BenchContext& context, uint64_t& bytes) {
+    double start = nowSeconds();
+    bool ok = writeEmployeeRecordsAsync(BENCH_BIN_FILE, context.source);
+    double elapsed = nowSeconds() - start;
+    bytes = sizeof(EmployeeFileHeader) + context.source.size() * sizeof(Employee);
+    return ok ? elapsed : -1;
+}
+
+double benchSort(BenchContext& context, uint64_t& bytes, SortAlgorithm algorithm) {
+    context.scratch = context.source;
+    double start = nowSeconds();
+    sortEmployees(context.scratch, algorithm, context.threads);
+    double elapsed = nowSeconds() - start;
+    bytes = context.scratch.size() * sizeof(Employee);
+    bool sorted = context.scratch.empty() || isSortedById(&context.scratch[0], context.scratch.size());
+    return sorted ? elapsed : -1;
+}
+
+double benchSortStd(BenchContext& context, uint64_t& bytes) { return benchSort(context, bytes, SORT_STD); }
+double benchSortParallel(BenchContext& context, uint64_t& bytes) { return benchSort(context, bytes, SORT_PARALLEL); }
+double benchSortRadix(BenchContext& context, uint64_t& bytes) { return benchSort(context, bytes, SORT_RADIX); }
+
+// форматирование строк отчета в память, без записи в файл
+double benchReportFormat(BenchContext& context, uint64_t& bytes) {
+    std::vector<char> buffer;
+    bytes = 0;
+    double start = nowSeconds();
+    for (size_t first = 0; first < context.source.size(); first += REPORT_CHUNK) {
+        size_t count = std::min(REPORT_CHUNK, context.source.size() - first);
+        formatReportChunk(&context.source[first], count, 12.5, buffer);
+        bytes += buffer.size();
+    }
+    return nowSeconds() - start;
+}
+
+double benchReportWrite(BenchContext& context, uint64_t& bytes) {
+    ReportWriter writer(12.5);
+    double start = nowSeconds();
+    bool ok = writer.open(BENCH_REPORT_FILE);
+    writer.writeHeader(BENCH_BIN_FILE);
+    if (!context.source.empty()) {
+        ok = ok && writeReportParallel(writer, &context.source[0], context.source.size(), context.threads);
+    }
+    ok = writer.close() && ok;
+    double elapsed = nowSeconds() - start;
+    std::ifstream report(BENCH_REPORT_FILE, std::ios::binary | std::ios::ate);
+    bytes = static_cast<uint64_t>(report.tellg());
+    return ok ? elapsed : -1;
+}
+
+// группировка по имени без записи отчета
+double benchGroupName(BenchContext& context, uint64_t& bytes) {
+    std::vector<NameGroup> groups;
+    double start = nowSeconds();
+    NameGroupBuilder builder(context.threads);
+    if (!context.source.empty()) builder.add(&context.source[0], context.source.size());
+    builder.finish(groups);
+    double elapsed = nowSeconds() - start;
+    bytes = context.source.size() * sizeof(Employee);
+    return groups.empty() == context.source.empty() ? elapsed : -1;
+}
+
+struct BenchCase {
+    const char* name;
+    BenchBody body;
+};
+
+const BenchCase BENCH_CASES[] = {
+    { "write", benchWrite },
+    { "read", benchRead },
+    { "load", benchLoad },
+    { "write_async", benchWriteAsync },
+    { "read_async", benchReadAsync },
+    { "sort_std", benchSortStd },
+    { "sort_parallel", benchSortParallel },
+    { "sort_radix", benchSortRadix },
+    { "report_format", benchReportFormat },
+    { "group_name", benchGroupName },
+    { "report_write", benchReportWrite }
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t records;
+    double seconds;  // лучшее время из повторов
+    uint64_t bytes;
+};
+
+std::string formatJsonNumber(double value) {
+    char text[64];
+    std::sprintf(text, "%.6g", value);
+    return text;
+}
+
+bool writeBenchJson(const char* filename, const std::vector<BenchResult>& results, unsigned threads,
+                    unsigned repeats) {
+    std::ofstream ofs(filename);
+    ofs << "{\n  \"context\": { \"threads\": " << threads << ", \"repeats\": " << repeats
+        << ", \"cplusplus\": " << __cplusplus << ", \"record_size\": " << sizeof(Employee) << " },\n";
+    ofs << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        ofs << "    { \"name\": \"" << r.name << "\", \"records\": " << r.records
+            << ", \"seconds\": " << formatJsonNumber(r.seconds)
+            << ", \"records_per_second\": " << formatJsonNumber(r.seconds > 0 ? r.records / r.seconds : 0)
+            << ", \"bytes_per_second\": " << formatJsonNumber(r.seconds > 0 ? r.bytes / r.seconds : 0)
+            << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    ofs << "  ]\n}\n";
+    return ofs.good();
+}
+
+// размеры через запятую: "1e3,1e4,2.5e5"
+bool parseSizes(const char* text, std::vector<uint64_t>& sizes) {
+    sizes.clear();
+    while (*text != '\0') {
+        char* end;
+        double value = std::strtod(text, &end);
+        if (end == text || value < 1) return false;
+        sizes.push_back(static_cast<uint64_t>(value));
+        text = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return false;
+    }
+    return !sizes.empty();
+}
+
+// Утилита lab1_bench замеряет запись, чтение, сортировку и форматирование отчета.
+// Необязательные параметры:
+// --sizes=N1,N2,... – числа записей (по умолчанию 1e3,1e4,1e5,1e6; допускаются до 1e8),
+// --repeat=R – повторов каждого замера, берется лучшее время (по умолчанию 3),
+// --filter=S – только замеры, в имени которых есть S,
+// --threads=N – потоки для parallel-сортировки и отчета (0 – по числу процессоров),
+// --json=F – результаты в JSON-файл F для сравнения между коммитами.
+int main(int argc, char* argv[]) {
+    std::vector<uint64_t> sizes;
+    parseSizes("1e3,1e4,1e5,1e6", sizes);
+    unsigned repeats = 3;
+    unsigned threads = 0;
+    const char* filter = "";
+    const char* jsonFilename = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--sizes=", 8) == 0) {
+            if (!parseSizes(argv[i] + 8, sizes)) {
+                std::cerr << "Неверный список размеров: " << argv[i] + 8 << std::endl;
+                return 1;
+            }
+        } else if (std::strncmp(argv[i], "--repeat=", 9) == 0) {
+            repeats = static_cast<unsigned>(std::atoi(argv[i] + 9));
+            if (repeats == 0) repeats = 1;
+        } else if (std::strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = static_cast<unsigned>(std::atoi(argv[i] + 10));
+        } else if (std::strncmp(argv[i], "--json=", 7) == 0) {
+            jsonFilename = argv[i] + 7;
+        } else {
+            std::cerr << "Usage: lab1_bench [--sizes=N1,N2,...] [--repeat=R] [--filter=S]"
+                      << " [--threads=N] [--json=file]" << std::endl;
+            return 1;
+        }
+    }
+    if (threads == 0) threads = hardwareThreadCount();
+
+    std::vector<BenchResult> results;
+    bool ok = true;
+    // setw считает байты, а не буквы UTF-8, поэтому шапка выровнена вручную
+    std::cout << "Замер                Записей           с   млн записей/с        МБ/с" << std::endl;
+    for (size_t s = 0; s < sizes.size(); s++) {
+        BenchContext context;
+        context.threads = threads;
+        GeneratorOptions options;
+        options.count = sizes[s];
+        options.ids = IDS_SHUFFLED;
+        options.seed = 42;
+        context.source.resize(static_cast<size_t>(sizes[s]));
+        EmployeeGenerator(options).generate(0, &context.source[0], context.source.size());
+
+        for (size_t c = 0; c < sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]); c++) {
+            const BenchCase& bench = BENCH_CASES[c];
+            if (std::strstr(bench.name, filter) == NULL) continue;
+            // чтению нужен файл, даже если замер записи отфильтрован
+            if (std::strcmp(bench.name, "read") == 0 || std::strcmp(bench.name, "load") == 0 ||
+                std::strcmp(bench.name, "read_async") == 0) {
+                writeEmployeeRecords(BENCH_BIN_FILE, context.source);
+            }
+
+            BenchResult result;
+            result.name = bench.name;
+            result.records = sizes[s];
+            result.seconds = -1;
+            result.bytes = 0;
+            for (unsigned r = 0; r < repeats; r++) {
+                uint64_t bytes = 0;
+                double elapsed = bench.body(context, bytes);
+                if (elapsed < 0) {
+                    std::cerr << "Замер " << bench.name << " завершился ошибкой." << std::endl;
+                    ok = false;
+                    break;
+                }
+                if (result.seconds < 0 || elapsed < result.seconds) result.seconds = elapsed;
+                result.bytes = bytes;
+            }
+            if (result.seconds < 0) continue;
+            results.push_back(result);
+            double perSecond = result.seconds > 0 ? 1 / result.seconds : 0;
+            std::cout << std::left << std::setw(16) << result.name << std::right << std::setw(12) << result.records
+                      << std::fixed << std::setprecision(6) << std::setw(12) << result.seconds
+                      << std::setprecision(2) << std::setw(16) << result.records * perSecond / 1e6
+                      << std::setw(12) << result.bytes * perSecond / 1e6 << std::endl;
+        }
+    }
+    std::remove(BENCH_BIN_FILE);
+    std::remove(BENCH_REPORT_FILE);
+
+    if (jsonFilename != NULL && !writeBenchJson(jsonFilename, results, threads, repeats)) {
+        std::cerr << "Ошибка записи файла результатов." << std::endl;
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
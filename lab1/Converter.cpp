@@ -0,0 +1,97 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include "Employee.h"
+#include "EmployeeFileWriter.h"
+#include "EmployeeFileView.h"
+#include "EmployeeCompression.h"
+#include "EmployeeBloom.h"
+
+// записей в одном куске при преобразовании
+const size_t CONVERT_CHUNK = 65536;
+
+// Утилита Converter переписывает бинарный файл в другой раскладке:
+// argv[1] – исходный файл (любая раскладка, в том числе без заголовка),
+// argv[2] – файл результата,
+// argv[3] – --to=packed (упакованные записи по 22 байта), --to=native (структуры Employee)
+// --to=columnar (колонки num, name, hours) или --to=compressed (сжатые блоки).
+// argv[4] – --bloom (необязательно): рядом с файлом результата построить фильтр
+// Блума по id <файл>.bloom.
+int main(int argc, char* argv[]) {
+    bool bloom = argc == 5 && std::strcmp(argv[4], "--bloom") == 0;
+    if (argc != 4 && !bloom) {
+        std::cerr << "Usage: Converter <source_file> <target_file> --to=packed|native|columnar|compressed [--bloom]"
+                  << std::endl;
+        return 1;
+    }
+
+    uint16_t format;
+    if (std::strcmp(argv[3], "--to=packed") == 0) {
+        format = EMPLOYEE_FORMAT_PACKED;
+    } else if (std::strcmp(argv[3], "--to=native") == 0) {
+        format = EMPLOYEE_FORMAT_NATIVE;
+    } else if (std::strcmp(argv[3], "--to=columnar") == 0) {
+        format = EMPLOYEE_FORMAT_COLUMNAR;
+    } else if (std::strcmp(argv[3], "--to=compressed") == 0) {
+        format = EMPLOYEE_FORMAT_COMPRESSED;
+    } else {
+        std::cerr << "Неизвестная раскладка: " << argv[3] << std::endl;
+        return 1;
+    }
+
+    std::ifstream ifs(argv[1], std::ios::binary);
+    EmployeeFileHeader header;
+    if (!ifs || !readEmployeeFileHeader(ifs, header)) {
+        std::cerr << "Ошибка чтения бинарного файла." << std::endl;
+        return 1;
+    }
+    // колоночную и сжатую раскладки потоком не прочитать и не записать: файл переводится целиком в памяти
+    if (!isRowEmployeeFormat(header.format) || !isRowEmployeeFormat(format)) {
+        ifs.close();
+        std::vector<Employee> employees;
+        if (!loadEmployeeRecords(argv[1], employees)) {
+            std::cerr << "Ошибка чтения бинарного файла." << std::endl;
+            return 1;
+        }
+        const Employee* data = employees.empty() ? NULL : &employees[0];
+        if (format == EMPLOYEE_FORMAT_COMPRESSED ? !writeEmployeeCompressed(argv[2], data, employees.size())
+                                                 : !writeEmployeeRecords(argv[2], employees, format)) {
+            std::cerr << "Ошибка преобразования файла." << std::endl;
+            return 1;
+        }
+        if (bloom) buildEmployeeBloomSidecar(argv[2], std::cerr);
+        std::cout << "Файл преобразован. Записей: " << employees.size() << "." << std::endl;
+        return 0;
+    }
+    EmployeeFileWriter writer;
+    if (!writer.open(argv[2], format)) {
+        std::cerr << "Ошибка при записи в файл." << std::endl;
+        return 1;
+    }
+
+    // файл читается кусками, память не зависит от размера файла
+    std::vector<Employee> chunk(CONVERT_CHUNK);
+    EmployeeChecksum checksum;
+    uint64_t remaining = header.recordCount;
+    bool ok = true;
+    while (ok && remaining > 0) {
+        size_t wanted = remaining < CONVERT_CHUNK ? static_cast<size_t>(remaining) : CONVERT_CHUNK;
+        size_t got = readEmployeeBlock(ifs, header, &chunk[0], wanted, checksum);
+        if (got == 0) break;
+        if (remaining != EMPLOYEE_COUNT_UNKNOWN) remaining -= got;
+        ok = writer.write(&chunk[0], got);
+    }
+    if (header.version != 0 && (remaining != 0 || checksum.value() != header.checksum)) {
+        std::cerr << "Исходный файл поврежден или обрезан." << std::endl;
+        ok = false;
+    }
+    if (!writer.close() || !ok) {
+        std::cerr << "Ошибка преобразования файла." << std::endl;
+        return 1;
+    }
+    if (bloom && std::strcmp(argv[2], "-") != 0) buildEmployeeBloomSidecar(argv[2], std::cerr);
+
+    std::cout << "Файл преобразован. Записей: " << writer.count() << "." << std::endl;
+    return 0;
+}
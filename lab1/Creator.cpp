@@ -2,15 +2,89 @@
 #include <fstream>
 #include <vector>
 #include <sstream>
+#include <string>
 #include <cstdlib>
+#include <cstring>
 #include "Employee.h"
+#include "EmployeeFileWriter.h"
+#include "IdHashSet.h"
+#include "EmployeeBloom.h"
+#include "Payroll.h"
+
+// Пакетная загрузка из CSV/TSV-файла или стандартного ввода ("-"), см. createEmployees.
+// При append записи дописываются в существующий файл без повторения его id.
+int importEmployees(const char* filename, const char* source, bool append, bool bloom) {
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (std::strcmp(source, "-") == 0) {
+        std::ios::sync_with_stdio(false);
+    } else {
+        file.open(source);
+        if (!file) {
+            std::cerr << "Ошибка открытия файла " << source << "." << std::endl;
+            return 1;
+        }
+        in = &file;
+    }
+
+    ImportStats stats;
+    if (append) {
+        EmployeeAppender appender;
+        appender.open(filename);
+        bool ok = createEmployees(*in, appender, stats, &std::cerr);
+        if (!appender.close() || !ok) {
+            std::cerr << "Ошибка при дописывании в файл." << std::endl;
+            return 1;
+        }
+        if (bloom) buildEmployeeBloomSidecar(filename, std::cerr);
+        std::cout << "Записи дописаны. Записей: " << stats.records
+                  << ", пропущено дубликатов: " << stats.duplicates
+                  << ", ошибочных строк: " << stats.errors << "." << std::endl;
+        return 0;
+    }
+
+    EmployeeFileWriter writer;
+    if (!writer.open(filename)) {
+        std::cerr << "Ошибка при записи в файл." << std::endl;
+        return 1;
+    }
+
+    bool ok = createEmployees(*in, writer, stats, &std::cerr);
+    if (!writer.close() || !ok) {
+        std::cerr << "Ошибка при записи в файл." << std::endl;
+        return 1;
+    }
+    if (bloom && std::strcmp(filename, "-") != 0) buildEmployeeBloomSidecar(filename, std::cerr);
+    // при выводе записей в стандартный вывод сообщения идут в поток ошибок
+    std::ostream& messages = std::strcmp(filename, "-") == 0 ? std::cerr : std::cout;
+    messages << "Файл успешно создан. Записей: " << stats.records
+             << ", пропущено дубликатов: " << stats.duplicates
+             << ", ошибочных строк: " << stats.errors << "." << std::endl;
+    return 0;
+}
 
 // Утилита Creator получает через командную строку:
-// argv[1] – имя бинарного файла для записи,
-// argv[2] – количество записей для вводаq.
+// argv[1] – имя бинарного файла для записи ("-" – записи без заголовка в стандартный вывод,
+//           каждая сразу после ввода; подсказки тогда выводятся в поток ошибок),
+// argv[2] – количество записей для ввода
+// или --import и argv[3] – CSV/TSV-файл (или "-" для стандартного ввода) с записями,
+// или --append и argv[3] – то же с дописыванием в файл; запускать можно несколько
+// Creator --append с одним файлом одновременно.
+// Последний параметр --bloom – рядом с файлом построить фильтр Блума по id
+// <файл>.bloom; при --append фильтр, если он уже есть, обновляется и без флага.
 int main(int argc, char* argv[]) {
+    bool bloom = argc > 1 && std::strcmp(argv[argc - 1], "--bloom") == 0;
+    if (bloom) argc--;
+    if (argc == 4 && std::strcmp(argv[2], "--import") == 0) {
+        return importEmployees(argv[1], argv[3], false, bloom);
+    }
+    if (argc == 4 && std::strcmp(argv[2], "--append") == 0 && std::strcmp(argv[1], "-") != 0) {
+        return importEmployees(argv[1], argv[3], true, bloom);
+    }
     if (argc != 3) {
-        std::cerr << "Usage: Creator <binary_file_name> <number_of_records>" << std::endl;
+        std::cerr << "Usage: Creator <binary_file_name> <number_of_records> [--bloom]" << std::endl;
+        std::cerr << "       Creator <binary_file_name> --import <csv_file|-> [--bloom]" << std::endl;
+        std::cerr << "       Creator <binary_file_name> --append <csv_file|-> [--bloom]" << std::endl;
         return 1;
     }
 
@@ -21,41 +95,56 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    bool toStdout = std::strcmp(filename, "-") == 0;
+    std::ostream& prompt = toStdout ? std::cerr : std::cout;
+    EmployeeFileWriter stream;
+    if (toStdout && !stream.open(filename)) {
+        std::cerr << "Ошибка при записи в файл." << std::endl;
+        return 1;
+    }
+
     std::vector<Employee> employees;
+    EmployeeIdSet ids;
     for (int i = 0; i < numRecords; i++) {
         Employee emp;
+        std::memset(&emp, 0, sizeof(emp));
         bool valid = false;
         while (!valid) {
-            std::cout << "Введите данные сотрудника " << i + 1 << ":\n";
-            std::cout << "ID: ";
+            prompt << "Введите данные сотрудника " << i + 1 << ":\n";
+            prompt << "ID: ";
             std::cin >> emp.num;
-    
-            bool duplicate = false;
-            for (size_t j = 0; j < employees.size(); j++) {
-                if (employees[j].num == emp.num) {
-                    duplicate = true;
-                    break;
-                }
-            }
-            if (duplicate) {
+
+            if (std::cin && ids.contains(emp.num)) {
                 std::cerr << "Ошибка: сотрудник с таким ID уже существует. Повторите ввод.\n";
-                continue;  
+                continue;
             }
-    
-            std::cout << "Имя (макс. 9 символов): ";
+
+            prompt << "Имя (макс. 9 символов): ";
             std::cin >> emp.name;
-            std::cout << "Отработанные часы: ";
+            prompt << "Отработанные часы: ";
             std::cin >> emp.hours;
+            // конец ввода или нечисловые данные: повторный ввод зациклился бы
+            if (!std::cin) {
+                std::cerr << "Ошибка ввода данных сотрудника." << std::endl;
+                return 1;
+            }
             valid = true;
         }
-        employees.push_back(emp);
+        ids.insert(emp.num);
+        // запись уходит читающему процессу, не дожидаясь остальных
+        if (toStdout && !(stream.write(emp) && stream.flush())) {
+            std::cerr << "Ошибка при записи в файл." << std::endl;
+            return 1;
+        }
+        if (!toStdout) employees.push_back(emp);
     }
 
-    if (!writeEmployeeRecords(filename, employees)) {
+    if (toStdout ? !stream.close() : !writeEmployeeRecords(filename, employees)) {
         std::cerr << "Ошибка при записи в файл." << std::endl;
         return 1;
     }
+    if (bloom && !toStdout) buildEmployeeBloomSidecar(filename, std::cerr);
 
-    std::cout << "Файл успешно создан." << std::endl;
+    prompt << "Файл успешно создан." << std::endl;
     return 0;
-}
\ No newline at end of file
+}
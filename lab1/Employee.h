@@ -6,6 +6,12 @@
 #include <vector>
 #include <algorithm>
 #include <cstring>
+#include <cstdio>
+#include <stdint.h>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
 
 struct Employee {
     int num;         // id
@@ -13,27 +19,490 @@ struct Employee {
     double hours;    // часы
 };
 
-// запись в бинарный файл
-inline bool writeEmployeeRecords(const char* filename, const std::vector<Employee>& employees)
+// Формат файла: заголовок EmployeeFileHeader, затем recordCount записей Employee.
+// Файлы без заголовка (старый формат – просто записи подряд) читаются как раньше.
+const char EMPLOYEE_FILE_MAGIC[4] = { 'E', 'M', 'P', 'F' };
+const uint16_t EMPLOYEE_FILE_VERSION = 1;
+// раскладка записей в файле
+enum EmployeeFileFormat {
+    EMPLOYEE_FORMAT_NATIVE = 0,  // структуры Employee как в памяти
+    EMPLOYEE_FORMAT_PACKED = 1,  // упакованные записи по 22 байта, little-endian
+    EMPLOYEE_FORMAT_COLUMNAR = 2,  // колонки num, name и hours подряд, см. employeeColumnLayout
+    EMPLOYEE_FORMAT_COMPRESSED = 3 // сжатые независимые блоки, см. EmployeeCompression.h
+};
+// флаги заголовка
+const uint32_t EMPLOYEE_FLAG_SORTED = 1;  // записи отсортированы по num
+// число записей неизвестно (файл без заголовка, читаемый из потока)
+const uint64_t EMPLOYEE_COUNT_UNKNOWN = ~static_cast<uint64_t>(0);
+const uint64_t EMPLOYEE_CHECKSUM_SEED = 14695981039104346656ULL;
+
+struct EmployeeFileHeader {
+    char magic[4];
+    uint16_t version;     // 0 – файл без заголовка
+    uint16_t format;      // EmployeeFileFormat
+    uint32_t recordSize;  // размер записи в файле: sizeof(Employee) или PACKED_EMPLOYEE_SIZE
+    uint32_t flags;
+    uint64_t recordCount;
+    uint64_t checksum;    // employeeChecksum от байтов всех записей
+};
+
+// контрольная сумма в духе FNV-1a по 8-байтовым словам; сумму можно продолжить:
+// employeeChecksum(b, employeeChecksum(a)) == сумма a и b подряд, если длина a кратна 8
+inline uint64_t employeeChecksum(const void* data, size_t bytes, uint64_t seed = EMPLOYEE_CHECKSUM_SEED)
+{
+    const uint64_t prime = 1099511628211ULL;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    size_t words = bytes / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t word;
+        std::memcpy(&word, p + i * 8, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (size_t i = words * 8; i < bytes; i++) {
+        hash = (hash ^ p[i]) * prime;
+    }
+    return hash;
+}
+
+// Потоковый подсчет той же контрольной суммы для данных, поступающих
+// кусками произвольной длины (например, упакованных записей по 22 байта).
+class EmployeeChecksum {
+public:
+    explicit EmployeeChecksum(uint64_t seed = EMPLOYEE_CHECKSUM_SEED) : hash_(seed), pendingSize_(0) {}
+
+    void update(const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        if (pendingSize_ > 0) {
+            size_t take = std::min(bytes, 8 - pendingSize_);
+            std::memcpy(pending_ + pendingSize_, p, take);
+            pendingSize_ += take;
+            p += take;
+            bytes -= take;
+            if (pendingSize_ < 8) return;
+            hash_ = employeeChecksum(pending_, 8, hash_);
+            pendingSize_ = 0;
+        }
+        size_t whole = bytes / 8 * 8;
+        hash_ = employeeChecksum(p, whole, hash_);
+        pendingSize_ = bytes - whole;
+        std::memcpy(pending_, p + whole, pendingSize_);
+    }
+
+    uint64_t value() const { return employeeChecksum(pending_, pendingSize_, hash_); }
+
+private:
+    uint64_t hash_;
+    unsigned char pending_[8];
+    size_t pendingSize_;
+};
+
+// Упакованная запись: num (4 байта), name (10 байт), hours (8 байт IEEE 754),
+// числа в little-endian, без выравнивания – одинаково на любой платформе.
+const size_t PACKED_EMPLOYEE_SIZE = 22;
+
+inline void encodePackedEmployee(const Employee& emp, unsigned char* out)
+{
+    uint32_t num = static_cast<uint32_t>(emp.num);
+    for (int i = 0; i < 4; i++) out[i] = static_cast<unsigned char>(num >> (8 * i));
+    // байты после завершающего нуля имени не переносятся
+    size_t nameLength = 0;
+    while (nameLength < sizeof(emp.name) && emp.name[nameLength] != '\0') nameLength++;
+    std::memcpy(out + 4, emp.name, nameLength);
+    std::memset(out + 4 + nameLength, 0, sizeof(emp.name) - nameLength);
+    uint64_t hours;
+    std::memcpy(&hours, &emp.hours, sizeof(hours));
+    for (int i = 0; i < 8; i++) out[14 + i] = static_cast<unsigned char>(hours >> (8 * i));
+}
+
+inline void decodePackedEmployee(const unsigned char* in, Employee& emp)
+{
+    std::memset(&emp, 0, sizeof(emp));
+    uint32_t num = 0;
+    for (int i = 0; i < 4; i++) num |= static_cast<uint32_t>(in[i]) << (8 * i);
+    emp.num = static_cast<int>(num);
+    std::memcpy(emp.name, in + 4, sizeof(emp.name));
+    uint64_t hours = 0;
+    for (int i = 0; i < 8; i++) hours |= static_cast<uint64_t>(in[14 + i]) << (8 * i);
+    std::memcpy(&emp.hours, &hours, sizeof(hours));
+}
+
+// Колоночная раскладка: после заголовка идут колонка num (int по 4 байта),
+// колонка name (по 10 байт), выравнивание до 8 байт и колонка hours (double).
+// Числа хранятся в порядке байтов платформы, чтобы колонки можно было
+// обрабатывать прямо из отображенной памяти.
+const size_t COLUMNAR_EMPLOYEE_SIZE = 4 + 10 + 8;
+
+// смещения колонок от начала файла
+struct EmployeeColumnLayout {
+    uint64_t numOffset;
+    uint64_t namesOffset;
+    uint64_t hoursOffset;
+    uint64_t end;
+};
+
+inline EmployeeColumnLayout employeeColumnLayout(uint64_t count)
+{
+    EmployeeColumnLayout layout;
+    layout.numOffset = sizeof(EmployeeFileHeader);
+    layout.namesOffset = layout.numOffset + count * sizeof(int);
+    layout.hoursOffset = (layout.namesOffset + count * 10 + 7) / 8 * 8;
+    layout.end = layout.hoursOffset + count * sizeof(double);
+    return layout;
+}
+
+inline bool isSortedById(const Employee* employees, size_t count)
+{
+    for (size_t i = 1; i < count; i++) {
+        if (employees[i].num < employees[i - 1].num) return false;
+    }
+    return true;
+}
+
+inline bool isSortedIds(const int* ids, size_t count)
+{
+    for (size_t i = 1; i < count; i++) {
+        if (ids[i] < ids[i - 1]) return false;
+    }
+    return true;
+}
+
+// размер записи в файле для раскладки format, 0 – раскладка не поддерживается
+inline uint32_t employeeRecordSize(uint16_t format)
+{
+    switch (format) {
+    case EMPLOYEE_FORMAT_NATIVE: return sizeof(Employee);
+    case EMPLOYEE_FORMAT_PACKED: return PACKED_EMPLOYEE_SIZE;
+    case EMPLOYEE_FORMAT_COLUMNAR: return COLUMNAR_EMPLOYEE_SIZE;
+    // у сжатых записей нет постоянного размера: указывается размер упакованной записи
+    case EMPLOYEE_FORMAT_COMPRESSED: return PACKED_EMPLOYEE_SIZE;
+    default: return 0;
+    }
+}
+
+// записи идут в файле одна за другой – файл можно читать и писать потоком
+inline bool isRowEmployeeFormat(uint16_t format)
+{
+    return format == EMPLOYEE_FORMAT_NATIVE || format == EMPLOYEE_FORMAT_PACKED;
+}
+
+// заголовок без записей для раскладки format
+inline EmployeeFileHeader makeEmptyEmployeeFileHeader(uint16_t format)
+{
+    EmployeeFileHeader header;
+    std::memcpy(header.magic, EMPLOYEE_FILE_MAGIC, sizeof(header.magic));
+    header.version = EMPLOYEE_FILE_VERSION;
+    header.format = format;
+    header.recordSize = employeeRecordSize(format);
+    header.flags = EMPLOYEE_FLAG_SORTED;
+    header.recordCount = 0;
+    header.checksum = EMPLOYEE_CHECKSUM_SEED;
+    return header;
+}
+
+// заголовок для записей в памяти
+inline EmployeeFileHeader makeEmployeeFileHeader(const Employee* employees, size_t count)
+{
+    EmployeeFileHeader header = makeEmptyEmployeeFileHeader(EMPLOYEE_FORMAT_NATIVE);
+    header.flags = isSortedById(employees, count) ? EMPLOYEE_FLAG_SORTED : 0;
+    header.recordCount = count;
+    header.checksum = employeeChecksum(employees, count * sizeof(Employee));
+    return header;
+}
+
+// двоичный режим стандартного потока: в Windows иначе портятся байты '\n' и 0x1A
+inline void setBinaryMode(FILE* file)
+{
+#ifdef _WIN32
+    _setmode(_fileno(file), _O_BINARY);
+#else
+    (void)file;
+#endif
+}
+
+// заголовок файла старого формата
+inline EmployeeFileHeader makeLegacyEmployeeFileHeader(uint64_t recordCount)
+{
+    EmployeeFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.recordSize = sizeof(Employee);
+    header.recordCount = recordCount;
+    return header;
+}
+
+inline bool hasEmployeeFileMagic(const void* data, size_t bytes)
+{
+    return bytes >= sizeof(EmployeeFileHeader) &&
+           std::memcmp(data, EMPLOYEE_FILE_MAGIC, sizeof(EMPLOYEE_FILE_MAGIC)) == 0;
+}
+
+// поддерживает ли программа версию и раскладку файла
+inline bool isSupportedEmployeeFileHeader(const EmployeeFileHeader& header)
+{
+    return header.version == EMPLOYEE_FILE_VERSION &&
+           header.recordSize != 0 &&
+           header.recordSize == employeeRecordSize(header.format);
+}
+
+// Чтение заголовка из начала потока. Для файла без заголовка поток
+// возвращается в начало, а в header записывается заголовок старого формата
+// с неизвестным числом записей. false – поток не читается или версия не поддерживается.
+inline bool readEmployeeFileHeader(std::istream& is, EmployeeFileHeader& header)
+{
+    is.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (is && hasEmployeeFileMagic(&header, sizeof(header))) {
+        return isSupportedEmployeeFileHeader(header);
+    }
+    is.clear();
+    is.seekg(0, std::ios::beg);
+    header = makeLegacyEmployeeFileHeader(EMPLOYEE_COUNT_UNKNOWN);
+    return !is.fail();
+}
+
+// Чтение до maxCount записей из потока, установленного на записи файла
+// с заголовком header, с переводом в Employee; байты записей учитываются в checksum.
+// Возвращает число прочитанных целых записей. Колоночную раскладку
+// так прочитать нельзя (см. isRowEmployeeFormat) – для нее возвращается 0.
+inline size_t readEmployeeBlock(std::istream& is, const EmployeeFileHeader& header,
+                                Employee* out, size_t maxCount, EmployeeChecksum& checksum)
+{
+    if (maxCount == 0 || !isRowEmployeeFormat(header.format)) return 0;
+    if (header.format == EMPLOYEE_FORMAT_PACKED) {
+        std::vector<unsigned char> bytes(maxCount * PACKED_EMPLOYEE_SIZE);
+        is.read(reinterpret_cast<char*>(&bytes[0]), bytes.size());
+        size_t count = static_cast<size_t>(is.gcount()) / PACKED_EMPLOYEE_SIZE;
+        checksum.update(&bytes[0], count * PACKED_EMPLOYEE_SIZE);
+        for (size_t i = 0; i < count; i++) decodePackedEmployee(&bytes[i * PACKED_EMPLOYEE_SIZE], out[i]);
+        return count;
+    }
+    is.read(reinterpret_cast<char*>(out), maxCount * sizeof(Employee));
+    size_t count = static_cast<size_t>(is.gcount()) / sizeof(Employee);
+    checksum.update(out, count * sizeof(Employee));
+    return count;
+}
+
+// запись count записей в поток в построчной раскладке format; байты учитываются в checksum
+inline bool writeEmployeeBlock(std::ostream& os, uint16_t format, const Employee* employees, size_t count,
+                               EmployeeChecksum& checksum)
+{
+    if (!isRowEmployeeFormat(format)) return false;
+    if (count == 0) return os.good();
+    if (format == EMPLOYEE_FORMAT_PACKED) {
+        std::vector<unsigned char> bytes(count * PACKED_EMPLOYEE_SIZE);
+        for (size_t i = 0; i < count; i++) encodePackedEmployee(employees[i], &bytes[i * PACKED_EMPLOYEE_SIZE]);
+        checksum.update(&bytes[0], bytes.size());
+        os.write(reinterpret_cast<const char*>(&bytes[0]), bytes.size());
+        return os.good();
+    }
+    checksum.update(employees, count * sizeof(Employee));
+    os.write(reinterpret_cast<const char*>(employees), count * sizeof(Employee));
+    return os.good();
+}
+
+// Запись записей в колоночной раскладке: по проходу на колонку, колонка
+// собирается кусками по 65536 записей. Поток должен стоять сразу за заголовком.
+inline bool writeEmployeeColumnar(std::ostream& os, const Employee* employees, size_t count,
+                                  EmployeeChecksum& checksum)
+{
+    const size_t step = 65536;
+    std::vector<char> chunk(step * 10);  // самая широкая колонка – name
+    for (int column = 0; column < 3; column++) {
+        if (column == 2) {
+            // выравнивание колонки hours
+            EmployeeColumnLayout layout = employeeColumnLayout(count);
+            size_t padding = static_cast<size_t>(layout.hoursOffset - layout.namesOffset) - count * 10;
+            os.write("\0\0\0\0\0\0\0", padding);
+        }
+        for (size_t i = 0; i < count; i += step) {
+            size_t n = std::min(step, count - i);
+            size_t bytes = 0;
+            for (size_t j = 0; j < n; j++) {
+                const Employee& emp = employees[i + j];
+                if (column == 0) {
+                    std::memcpy(&chunk[bytes], &emp.num, sizeof(int));
+                    bytes += sizeof(int);
+                } else if (column == 1) {
+                    std::memcpy(&chunk[bytes], emp.name, sizeof(emp.name));
+                    bytes += sizeof(emp.name);
+                } else {
+                    std::memcpy(&chunk[bytes], &emp.hours, sizeof(double));
+                    bytes += sizeof(double);
+                }
+            }
+            checksum.update(&chunk[0], bytes);
+            os.write(&chunk[0], bytes);
+        }
+    }
+    return os.good();
+}
+
+// Чтение count записей колоночной раскладки; поток должен стоять сразу за заголовком
+inline bool readEmployeeColumnar(std::istream& is, Employee* employees, size_t count, EmployeeChecksum& checksum)
+{
+    const size_t step = 65536;
+    std::vector<char> chunk(step * 10);  // самая широкая колонка – name
+    EmployeeColumnLayout layout = employeeColumnLayout(count);
+    for (int column = 0; column < 3; column++) {
+        size_t width = column == 0 ? sizeof(int) : column == 1 ? 10 : sizeof(double);
+        if (column == 2) is.seekg(static_cast<std::streamoff>(layout.hoursOffset), std::ios::beg);
+        for (size_t i = 0; i < count; i += step) {
+            size_t n = std::min(step, count - i);
+            is.read(&chunk[0], n * width);
+            if (!is) return false;
+            checksum.update(&chunk[0], n * width);
+            for (size_t j = 0; j < n; j++) {
+                Employee& emp = employees[i + j];
+                if (column == 0) {
+                    std::memset(&emp, 0, sizeof(emp));
+                    std::memcpy(&emp.num, &chunk[j * width], width);
+                } else if (column == 1) {
+                    std::memcpy(emp.name, &chunk[j * width], width);
+                } else {
+                    std::memcpy(&emp.hours, &chunk[j * width], width);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// запись в бинарный файл; format – раскладка записей (EmployeeFileFormat)
+inline bool writeEmployeeRecords(const char* filename, const std::vector<Employee>& employees,
+                                 uint16_t format = EMPLOYEE_FORMAT_NATIVE)
 {
     std::ofstream ofs(filename, std::ios::binary);
     if (!ofs) return false;
-    for (size_t i = 0; i < employees.size(); i++) {
-        ofs.write(reinterpret_cast<const char*>(&employees[i]), sizeof(Employee));
+    const Employee* data = employees.empty() ? NULL : &employees[0];
+    EmployeeFileHeader header = makeEmployeeFileHeader(data, employees.size());
+    if (format != EMPLOYEE_FORMAT_NATIVE) {
+        header.format = format;
+        header.recordSize = employeeRecordSize(format);
+        // сжатый файл пишет writeEmployeeCompressed (EmployeeCompression.h)
+        if (header.recordSize == 0 || format == EMPLOYEE_FORMAT_COMPRESSED) return false;
+        // заголовок дописывается после подсчета суммы записанных байтов
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        EmployeeChecksum checksum;
+        if (format == EMPLOYEE_FORMAT_COLUMNAR) {
+            writeEmployeeColumnar(ofs, data, employees.size(), checksum);
+        }
+        for (size_t i = 0; format != EMPLOYEE_FORMAT_COLUMNAR && i < employees.size(); i += 65536) {
+            writeEmployeeBlock(ofs, format, data + i, std::min<size_t>(65536, employees.size() - i), checksum);
+        }
+        header.checksum = checksum.value();
+        ofs.seekp(0, std::ios::beg);
+    }
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (format == EMPLOYEE_FORMAT_NATIVE && data != NULL) {
+        ofs.write(reinterpret_cast<const char*>(data), employees.size() * sizeof(Employee));
     }
     return ofs.good();
 }
 
-// чтение из бинарного файлы
-inline bool readEmployeeRecords(const char* filename, std::vector<Employee>& employees)
+// Чтение записей из потока без перемотки (канал, стандартный ввод) до его конца.
+// Поток с заголовком читается по заголовку построчными раскладками; поток без
+// заголовка – записи Employee подряд, как их пишет Creator в "-".
+inline bool readEmployeeStream(std::istream& is, std::vector<Employee>& employees,
+                               EmployeeFileHeader* header = NULL)
 {
+    const size_t step = 65536;
+    size_t first = employees.size();
+    EmployeeFileHeader fileHeader;
+    is.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+    size_t prefix = static_cast<size_t>(is.gcount());
+
+    if (prefix == sizeof(fileHeader) && hasEmployeeFileMagic(&fileHeader, sizeof(fileHeader))) {
+        if (!isSupportedEmployeeFileHeader(fileHeader) || !isRowEmployeeFormat(fileHeader.format)) return false;
+        EmployeeChecksum checksum;
+        uint64_t done = 0;
+        while (done < fileHeader.recordCount) {
+            size_t wanted = static_cast<size_t>(std::min<uint64_t>(step, fileHeader.recordCount - done));
+            employees.resize(first + done + wanted);
+            size_t got = readEmployeeBlock(is, fileHeader, &employees[first + done], wanted, checksum);
+            done += got;
+            if (got != wanted) break;
+        }
+        if (done != fileHeader.recordCount || checksum.value() != fileHeader.checksum) {
+            employees.resize(first);
+            return false;
+        }
+        if (header != NULL) *header = fileHeader;
+        return true;
+    }
+
+    // без заголовка: уже прочитанные байты – начало первых записей
+    size_t bytes = prefix;
+    employees.resize(first + step);
+    std::memcpy(&employees[first], &fileHeader, prefix);
+    while (is) {
+        if ((employees.size() - first) * sizeof(Employee) - bytes < step * sizeof(Employee) / 2) {
+            employees.resize(employees.size() + step);
+        }
+        size_t room = (employees.size() - first) * sizeof(Employee) - bytes;
+        is.read(reinterpret_cast<char*>(&employees[first]) + bytes, room);
+        bytes += static_cast<size_t>(is.gcount());
+    }
+    // неполная запись в конце отбрасывается, как и для файла старого формата
+    employees.resize(first + bytes / sizeof(Employee));
+    if (header != NULL) *header = makeLegacyEmployeeFileHeader(bytes / sizeof(Employee));
+    return is.eof();
+}
+
+// Чтение из бинарного файла любой раскладки. Для файла с заголовком вектор
+// заполняется за одно выделение памяти, а обрезанный файл или несовпадение
+// контрольной суммы считаются ошибкой. Если передан header, в него записывается заголовок файла.
+// Имя "-" – стандартный ввод (см. readEmployeeStream).
+inline bool readEmployeeRecords(const char* filename, std::vector<Employee>& employees,
+                                EmployeeFileHeader* header = NULL)
+{
+    if (std::strcmp(filename, "-") == 0) return readEmployeeStream(std::cin, employees, header);
     std::ifstream ifs(filename, std::ios::binary);
     if (!ifs) return false;
-    Employee emp;
-    while (ifs.read(reinterpret_cast<char*>(&emp), sizeof(Employee))) {
-        employees.push_back(emp);
+    EmployeeFileHeader fileHeader;
+    if (!readEmployeeFileHeader(ifs, fileHeader)) return false;
+    // сжатый файл читает loadEmployeeRecords (EmployeeFileView.h) через readEmployeeCompressed
+    if (fileHeader.format == EMPLOYEE_FORMAT_COMPRESSED) return false;
+
+    // число целых записей после заголовка
+    std::streampos start = ifs.tellg();
+    ifs.seekg(0, std::ios::end);
+    uint64_t available = static_cast<uint64_t>(ifs.tellg() - start) / fileHeader.recordSize;
+    ifs.seekg(start);
+
+    if (fileHeader.version == 0) {
+        // старый формат: записи до конца файла, неполная запись в конце отбрасывается
+        fileHeader.recordCount = available;
+    } else if (fileHeader.recordCount > available) {
+        // файл обрезан
+        return false;
+    }
+
+    size_t first = employees.size();
+    size_t count = static_cast<size_t>(fileHeader.recordCount);
+    employees.resize(first + count);
+    EmployeeChecksum checksum;
+    if (fileHeader.format == EMPLOYEE_FORMAT_COLUMNAR &&
+        count > 0 && !readEmployeeColumnar(ifs, &employees[first], count, checksum)) {
+        employees.resize(first);
+        return false;
+    }
+    // упакованные записи переводятся кусками, чтобы не держать в памяти весь файл дважды
+    size_t step = fileHeader.format == EMPLOYEE_FORMAT_NATIVE ? count : 65536;
+    for (size_t done = 0; fileHeader.format != EMPLOYEE_FORMAT_COLUMNAR && done < count;) {
+        size_t wanted = std::min(step, count - done);
+        size_t got = readEmployeeBlock(ifs, fileHeader, &employees[first + done], wanted, checksum);
+        if (got != wanted) {
+            employees.resize(first);
+            return false;
+        }
+        done += got;
+    }
+    if (fileHeader.version != 0 && checksum.value() != fileHeader.checksum) {
+        employees.resize(first);
+        return false;
     }
-    return ifs.eof();
+    if (header != NULL) *header = fileHeader;
+    return true;
 }
 
 // компаратор для сортировки по id по возрастанию
@@ -0,0 +1,409 @@
+#ifndef EMPLOYEE_APPEND_H
+#define EMPLOYEE_APPEND_H
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Employee.h"
+#include "EmployeeAsyncIO.h"
+#include "EmployeeBloom.h"
+#include "EmployeeFileView.h"
+#include "EmployeeFileWriter.h"
+#include "EmployeeIndex.h"
+#include "IdHashSet.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <sys/file.h>
+#endif
+
+// Дописывание записей в файл сотрудников несколькими процессами сразу.
+// Каждая пачка дописывается под исключительной рекомендательной блокировкой
+// файла (flock, в Windows – LockFileEx) одним вызовом write() в режиме
+// O_APPEND, после чего в заголовке обновляются число записей и контрольная
+// сумма (продолжением суммы старых записей). Читатели без блокировки видят
+// по заголовку целое число уже дописанных пачек: заголовок меняется последним.
+// Записи, оставшиеся после заголовка от прерванного процесса, отбрасываются
+// следующим дописыванием.
+// Под той же блокировкой новые записи добавляются в индекс <файл>.idx и
+// фильтр Блума <файл>.bloom на месте, за время, пропорциональное размеру пачки,
+// а не файла. Поэтому утилиты, читающие индекс и фильтр, берут разделяемую
+// блокировку файла, а перестраивающие их – исключительную.
+
+// итоги дописывания
+struct AppendStats {
+    uint64_t records;     // дописано записей
+    uint64_t duplicates;  // пропущено записей с id, который уже есть в файле или раньше в пачке
+    uint64_t recovered;   // отброшено байт незавершенного дописывания
+
+    AppendStats() : records(0), duplicates(0), recovered(0) {}
+};
+
+// исключительная или разделяемая блокировка открытого файла на время жизни объекта
+class EmployeeFileLock {
+public:
+    explicit EmployeeFileLock(int fd, bool exclusive = true) : fd_(fd), locked_(false) {
+#ifdef _WIN32
+        OVERLAPPED overlapped;
+        std::memset(&overlapped, 0, sizeof(overlapped));
+        locked_ = LockFileEx(reinterpret_cast<HANDLE>(_get_osfhandle(fd_)), exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0,
+                             0, MAXDWORD, MAXDWORD, &overlapped) != 0;
+#else
+        int result;
+        while ((result = flock(fd_, exclusive ? LOCK_EX : LOCK_SH)) != 0 && errno == EINTR) {}
+        locked_ = result == 0;
+#endif
+    }
+
+    ~EmployeeFileLock() {
+        if (!locked_) return;
+#ifdef _WIN32
+        OVERLAPPED overlapped;
+        std::memset(&overlapped, 0, sizeof(overlapped));
+        UnlockFileEx(reinterpret_cast<HANDLE>(_get_osfhandle(fd_)), 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+        flock(fd_, LOCK_UN);
+#endif
+    }
+
+    bool locked() const { return locked_; }
+
+private:
+    EmployeeFileLock(const EmployeeFileLock&);
+    EmployeeFileLock& operator=(const EmployeeFileLock&);
+
+    int fd_;
+    bool locked_;
+};
+
+inline uint64_t descriptorSize(int fd)
+{
+#ifdef _WIN32
+    struct _stati64 st;
+    return _fstati64(fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+#else
+    struct stat st;
+    return fstat(fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+#endif
+}
+
+// время изменения открытого файла в тех же единицах, что MappedFile::modified()
+inline uint64_t descriptorModifiedTime(int fd)
+{
+#ifdef _WIN32
+    return handleModifiedTime(reinterpret_cast<HANDLE>(_get_osfhandle(fd)));
+#else
+    struct stat st;
+    return fstat(fd, &st) == 0 ? statModifiedTime(st) : 0;
+#endif
+}
+
+inline bool truncateDescriptor(int fd, uint64_t size)
+{
+#ifdef _WIN32
+    return _chsize_s(fd, static_cast<__int64>(size)) == 0;
+#else
+    return ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+// открытие существующего файла для записи на место, без O_APPEND и усечения
+inline int openEmployeeFileForUpdate(const char* filename)
+{
+#ifdef _WIN32
+    return _open(filename, _O_WRONLY | _O_BINARY);
+#else
+    return ::open(filename, O_WRONLY | O_CLOEXEC);
+#endif
+}
+
+// запись в конец файла, открытого с O_APPEND
+inline bool appendBytes(int fd, const void* data, size_t size)
+{
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+#ifdef _WIN32
+        long n = _write(fd, p, static_cast<unsigned>(size));
+#else
+        long n = ::write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Фильтр, который после дописывания вмещал бы больше capacity() id, строится
+// заново с запасом вдвое: перестройка за O(n) приходится на каждые O(n) id.
+// Так же заново строится устаревший фильтр. id берутся из индекса, если он уже
+// дополнен, иначе из самого файла.
+inline bool rebuildAppendedBloom(const char* filename, const char* bloomFilename, const EmployeeIndex* index,
+                                 const EmployeeFileStamp& stamp)
+{
+    EmployeeBloomBuilder builder(2 * stamp.recordCount);
+    if (index != NULL) {
+        for (size_t r = 0; r < index->runCount(); r++) {
+            for (EmployeeIndex::const_iterator it = index->run(r).first; it != index->run(r).second; ++it) {
+                builder.add(it->num);
+            }
+        }
+    } else {
+        EmployeeFileView view;
+        if (!view.open(filename)) return false;
+        builder.add(view.data(), view.size());
+    }
+    std::string tempFilename = std::string(bloomFilename) + ".tmp";
+    if (!builder.write(tempFilename.c_str(), stamp)) {
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+    std::remove(bloomFilename);
+    return std::rename(tempFilename.c_str(), bloomFilename) == 0;
+}
+
+// Дописывание пачки под блокировкой: fd открыт с O_APPEND, headerFd – для
+// перезаписи заголовка на месте (при O_APPEND позиционная запись тоже ушла бы
+// в конец).
+inline bool appendEmployeeRecordsLocked(int fd, int headerFd, const char* filename, std::vector<Employee>& batch,
+                                        bool uniqueIds, AppendStats& stats)
+{
+    uint64_t size = descriptorSize(fd);
+    EmployeeFileHeader header;
+    if (size == 0) {
+        header = makeEmployeeFileHeader(NULL, 0);
+        if (!appendBytes(fd, &header, sizeof(header))) return false;
+        size = sizeof(header);
+    } else if (size >= sizeof(header) &&
+               transferAt(fd, false, reinterpret_cast<char*>(&header), sizeof(header), 0) ==
+                   static_cast<long>(sizeof(header)) &&
+               hasEmployeeFileMagic(&header, sizeof(header))) {
+        // дописывать можно только записи Employee: сумма продолжается с целых 8-байтовых слов
+        if (!isSupportedEmployeeFileHeader(header) || header.format != EMPLOYEE_FORMAT_NATIVE) return false;
+    } else {
+        header = makeLegacyEmployeeFileHeader(size / sizeof(Employee));
+    }
+
+    // граница последней завершенной пачки; хвост за ней оставил прерванный процесс
+    uint64_t committed = employeeRecordsOffset(header) + header.recordCount * sizeof(Employee);
+    if (size < committed) return false;
+    if (size > committed) {
+        if (!truncateDescriptor(fd, committed)) return false;
+        stats.recovered += size - committed;
+    }
+    EmployeeFileStamp before =
+        makeEmployeeFileStamp(header, header.recordCount, committed, descriptorModifiedTime(fd));
+
+    // индекс и фильтр, построенные по файлу до дописывания
+    std::string indexFilename = employeeIndexFilename(filename);
+    std::string bloomFilename = employeeBloomFilename(filename);
+    EmployeeIndex index;
+    bool indexed = index.open(indexFilename.c_str()) && index.matches(before);
+    EmployeeBloom bloom;
+    bool filterExists = bloom.openForUpdate(bloomFilename.c_str());
+    bool filtered = filterExists && bloom.matches(before);
+
+    if (uniqueIds) {
+        // без индекса id файла неизвестны: он строится целиком один раз
+        if (!indexed) {
+            index.close();
+            EmployeeFileView view;
+            std::vector<EmployeeIndexEntry> entries;
+            if (!view.open(filename)) return false;
+            makeEmployeeIndexEntries(view, entries);
+            view.close();
+            if (!writeEmployeeIndex(indexFilename.c_str(), before, entries) || !index.open(indexFilename.c_str())) {
+                return false;
+            }
+            indexed = true;
+        }
+        // пропуск id, которые уже есть в файле или повторяются в пачке;
+        // фильтр отсекает почти все новые id без поиска по участкам индекса
+        EmployeeIdSet seen(batch.size());
+        size_t kept = 0;
+        for (size_t i = 0; i < batch.size(); i++) {
+            int num = batch[i].num;
+            if (!seen.insert(num) || ((!filtered || bloom.mayContain(num)) && index.contains(num))) {
+                stats.duplicates++;
+                continue;
+            }
+            batch[kept++] = batch[i];
+        }
+        batch.resize(kept);
+    }
+    if (batch.empty()) return true;
+
+    // флаг сортировки сохраняется, если пачка продолжает порядок по id
+    bool sorted = (header.flags & EMPLOYEE_FLAG_SORTED) != 0 && isSortedById(&batch[0], batch.size());
+    if (sorted && header.recordCount > 0) {
+        Employee last;
+        sorted = transferAt(fd, false, reinterpret_cast<char*>(&last), sizeof(last), committed - sizeof(last)) ==
+                     static_cast<long>(sizeof(last)) &&
+                 last.num <= batch[0].num;
+    }
+
+    if (!appendBytes(fd, &batch[0], batch.size() * sizeof(Employee))) return false;
+    stats.records += batch.size();
+
+    header.recordCount += batch.size();
+    if (header.version != 0) {
+        EmployeeChecksum checksum(header.checksum);
+        checksum.update(&batch[0], batch.size() * sizeof(Employee));
+        header.checksum = checksum.value();
+        header.flags = sorted ? (header.flags | EMPLOYEE_FLAG_SORTED) : (header.flags & ~EMPLOYEE_FLAG_SORTED);
+        if (transferAt(headerFd, true, reinterpret_cast<char*>(&header), sizeof(header), 0) !=
+            static_cast<long>(sizeof(header))) {
+            return false;
+        }
+    }
+    EmployeeFileStamp after = makeEmployeeFileStamp(header, header.recordCount,
+                                                    committed + batch.size() * sizeof(Employee),
+                                                    descriptorModifiedTime(fd));
+
+    // Записи уже в файле, поэтому индекс и фильтр, которые не удалось дополнить,
+    // только удаляются: устаревшими их не оставит ни один путь дописывания,
+    // а утилиты поиска построят их заново. Фильтр строится, только если он уже
+    // был: он необязателен.
+    index.close();
+    bool indexUpdated = false;
+    if (indexed) {
+        std::vector<EmployeeIndexEntry> added(batch.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            added[i].num = batch[i].num;
+            added[i].reserved = 0;
+            added[i].offset = committed + static_cast<uint64_t>(i) * sizeof(Employee);
+        }
+        indexUpdated = appendEmployeeIndexEntries(indexFilename.c_str(), before, after, added);
+    }
+    if (!indexUpdated) std::remove(indexFilename.c_str());
+
+    bool bloomUpdated = false;
+    if (filtered && after.recordCount <= bloom.capacity()) {
+        bloom.add(&batch[0], batch.size());
+        bloom.setStamp(after);
+        bloomUpdated = true;
+    } else if (filterExists) {
+        bloom.close();
+        bool fromIndex = indexUpdated && index.open(indexFilename.c_str());
+        bloomUpdated = rebuildAppendedBloom(filename, bloomFilename.c_str(), fromIndex ? &index : NULL, after);
+    }
+    if (!bloomUpdated) {
+        bloom.close();
+        std::remove(bloomFilename.c_str());
+    }
+    return true;
+}
+
+// Файл, открытый для дописывания пачками: оба дескриптора открываются один
+// раз на все пачки.
+class EmployeeAppendFile {
+public:
+    EmployeeAppendFile() : fd_(-1), headerFd_(-1) {}
+    ~EmployeeAppendFile() { close(); }
+
+    // если файла нет, он создается; заголовок пишет первое дописывание
+    bool open(const char* filename) {
+        close();
+#ifdef _WIN32
+        fd_ = _open(filename, _O_RDWR | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        fd_ = ::open(filename, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+        if (fd_ < 0) return false;
+        headerFd_ = openEmployeeFileForUpdate(filename);
+        if (headerFd_ < 0) {
+            close();
+            return false;
+        }
+        filename_ = filename;
+        return true;
+    }
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    bool append(std::vector<Employee>& batch, bool uniqueIds, AppendStats& stats) {
+        EmployeeFileLock lock(fd_);
+        return lock.locked() &&
+               appendEmployeeRecordsLocked(fd_, headerFd_, filename_.c_str(), batch, uniqueIds, stats);
+    }
+
+    void close() {
+        if (fd_ >= 0) closeAsyncFile(fd_);
+        if (headerFd_ >= 0) closeAsyncFile(headerFd_);
+        fd_ = -1;
+        headerFd_ = -1;
+    }
+
+private:
+    EmployeeAppendFile(const EmployeeAppendFile&);
+    EmployeeAppendFile& operator=(const EmployeeAppendFile&);
+
+    int fd_;
+    int headerFd_;
+    std::string filename_;
+};
+
+// Дописывание пачки записей; если файла нет, он создается с заголовком.
+// При uniqueIds записи с id, которые уже есть в файле (по индексу <файл>.idx)
+// или повторяются в пачке, пропускаются. Индекс и фильтр Блума <файл>.bloom
+// дополняются новыми записями при любом uniqueIds; без uniqueIds индекс, которого
+// не было, не строится.
+// Дописывать можно в файл в раскладке Employee с заголовком или без него.
+inline bool appendEmployeeRecords(const char* filename, const Employee* employees, size_t count,
+                                  bool uniqueIds = true, AppendStats* stats = NULL)
+{
+    AppendStats localStats;
+    AppendStats& result = stats != NULL ? *stats : localStats;
+    EmployeeAppendFile file;
+    std::vector<Employee> batch(employees, employees + count);
+    return file.open(filename) && file.append(batch, uniqueIds, result);
+}
+
+// Приемник записей для createEmployees: копит пачку и дописывает ее целиком.
+class EmployeeAppender {
+public:
+    explicit EmployeeAppender(bool uniqueIds = true, size_t batchSize = EMPLOYEE_WRITER_CHUNK)
+        : uniqueIds_(uniqueIds), batchSize_(batchSize > 0 ? batchSize : 1) {}
+
+    bool open(const char* filename) {
+        file_.close();
+        filename_ = filename;
+        buffer_.clear();
+        stats_ = AppendStats();
+        return true;
+    }
+
+    bool write(const Employee& emp) {
+        buffer_.push_back(emp);
+        return buffer_.size() < batchSize_ || flush();
+    }
+
+    // файл открывается при первой пачке и остается открытым до close()
+    bool flush() {
+        bool ok = buffer_.empty() || ((file_.isOpen() || file_.open(filename_.c_str())) &&
+                                      file_.append(buffer_, uniqueIds_, stats_));
+        buffer_.clear();
+        return ok;
+    }
+
+    bool close() {
+        bool ok = flush();
+        file_.close();
+        return ok;
+    }
+
+    const AppendStats& stats() const { return stats_; }
+
+private:
+    bool uniqueIds_;
+    size_t batchSize_;
+    std::string filename_;
+    std::vector<Employee> buffer_;
+    EmployeeAppendFile file_;
+    AppendStats stats_;
+};
+
+#endif // EMPLOYEE_APPEND_H
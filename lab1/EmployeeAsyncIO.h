@@ -0,0 +1,652 @@
+#ifndef EMPLOYEE_ASYNC_IO_H
+#define EMPLOYEE_ASYNC_IO_H
+
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "Employee.h"
+#include "EmployeeFileView.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define EMPLOYEE_HAS_IO_URING 1
+#endif
+#endif
+#endif
+
+// Асинхронное чтение и запись файлов блоками: несколько блоков одновременно
+// находятся в очереди устройства, а потребитель тем временем обрабатывает
+// уже прочитанные. Это скрывает задержку сетевых и «холодных» дисков.
+
+// способ выполнения запросов
+enum AsyncBackend {
+    ASYNC_AUTO,     // io_uring, если ядро его разрешает, иначе потоки
+    ASYNC_URING,    // io_uring (Linux 5.1+)
+    ASYNC_THREADS,  // пул потоков с pread/pwrite (POSIX)
+    ASYNC_SYNC      // по одному запросу в вызывающем потоке
+};
+
+// размер блока одного запроса
+const size_t ASYNC_BLOCK_SIZE = 1 << 20;
+// блоков в очереди при чтении
+const unsigned ASYNC_READ_DEPTH = 8;
+// потоков пула при ASYNC_THREADS
+const unsigned ASYNC_MAX_WORKERS = 4;
+
+inline bool parseAsyncBackend(const char* name, AsyncBackend& backend)
+{
+    if (std::strcmp(name, "auto") == 0) backend = ASYNC_AUTO;
+    else if (std::strcmp(name, "uring") == 0) backend = ASYNC_URING;
+    else if (std::strcmp(name, "threads") == 0) backend = ASYNC_THREADS;
+    else if (std::strcmp(name, "sync") == 0) backend = ASYNC_SYNC;
+    else return false;
+    return true;
+}
+
+inline const char* asyncBackendName(AsyncBackend backend)
+{
+    switch (backend) {
+    case ASYNC_URING: return "uring";
+    case ASYNC_THREADS: return "threads";
+    case ASYNC_SYNC: return "sync";
+    default: return "auto";
+    }
+}
+
+// Позиционное чтение или запись size байт целиком; повторяется при неполной передаче.
+// Возвращает число переданных байт (меньше size только при конце файла) или -1.
+inline long transferAt(int fd, bool write, char* buffer, size_t size, uint64_t offset)
+{
+    size_t done = 0;
+    while (done < size) {
+#ifdef _WIN32
+        if (_lseeki64(fd, static_cast<__int64>(offset + done), SEEK_SET) < 0) return -1;
+        unsigned part = static_cast<unsigned>(size - done);
+        long n = write ? _write(fd, buffer + done, part) : _read(fd, buffer + done, part);
+#else
+        long n = write ? pwrite(fd, buffer + done, size - done, static_cast<off_t>(offset + done))
+                       : pread(fd, buffer + done, size - done, static_cast<off_t>(offset + done));
+#endif
+        if (n < 0) return -1;
+        if (n == 0) break;
+        done += static_cast<size_t>(n);
+    }
+    return static_cast<long>(done);
+}
+
+// запрос одной ячейки очереди
+struct AsyncRequest {
+    char* buffer;
+    size_t size;
+    uint64_t offset;
+    bool write;
+    bool pending;  // отправлен и еще не завершен
+    long result;   // переданных байт или -1
+#ifdef EMPLOYEE_HAS_IO_URING
+    struct iovec iov;
+#endif
+};
+
+// Очередь из depth ячеек поверх одного из способов выполнения запросов.
+// Ячейка отправляется submit() и ожидается wait(); одновременно в работе
+// может быть до depth запросов.
+class AsyncIoQueue {
+public:
+    AsyncIoQueue() : fd_(-1), backend_(ASYNC_SYNC), stop_(false)
+#ifdef EMPLOYEE_HAS_IO_URING
+        , ring_(-1), sqRing_(NULL), cqRing_(NULL), sqes_(NULL), sqRingSize_(0), cqRingSize_(0), sqesSize_(0)
+#endif
+    {}
+    ~AsyncIoQueue() { close(); }
+
+    bool open(int fd, AsyncBackend backend, unsigned depth) {
+        close();
+        fd_ = fd;
+        requests_.assign(depth > 0 ? depth : 1, AsyncRequest());
+        for (size_t i = 0; i < requests_.size(); i++) requests_[i].pending = false;
+#ifdef EMPLOYEE_HAS_IO_URING
+        if ((backend == ASYNC_AUTO || backend == ASYNC_URING) && openRing()) {
+            backend_ = ASYNC_URING;
+            return true;
+        }
+#endif
+        // io_uring недоступен (старое ядро, запрет seccomp) – запросы выполняет пул потоков
+        if (backend == ASYNC_URING) backend = ASYNC_AUTO;
+#ifndef _WIN32
+        if ((backend == ASYNC_AUTO || backend == ASYNC_THREADS) && startWorkers()) {
+            backend_ = ASYNC_THREADS;
+            return true;
+        }
+#endif
+        backend_ = ASYNC_SYNC;
+        return true;
+    }
+
+    void close() {
+        for (size_t i = 0; i < requests_.size(); i++) {
+            if (requests_[i].pending) wait(i);
+        }
+#ifdef EMPLOYEE_HAS_IO_URING
+        closeRing();
+#endif
+#ifndef _WIN32
+        stopWorkers();
+#endif
+        requests_.clear();
+        fd_ = -1;
+    }
+
+    AsyncBackend backend() const { return backend_; }
+    size_t depth() const { return requests_.size(); }
+
+    bool submit(size_t slot, bool write, char* buffer, size_t size, uint64_t offset) {
+        AsyncRequest& request = requests_[slot];
+        request.buffer = buffer;
+        request.size = size;
+        request.offset = offset;
+        request.write = write;
+        request.result = -1;
+        request.pending = true;
+#ifdef EMPLOYEE_HAS_IO_URING
+        if (backend_ == ASYNC_URING) return submitRing(slot);
+#endif
+#ifndef _WIN32
+        if (backend_ == ASYNC_THREADS) {
+            pthread_mutex_lock(&mutex_);
+            queue_.push_back(slot);
+            pthread_cond_signal(&work_);
+            pthread_mutex_unlock(&mutex_);
+        }
+#endif
+        return true;
+    }
+
+    // ожидание завершения запроса ячейки; возвращает число переданных байт или -1
+    long wait(size_t slot) {
+        AsyncRequest& request = requests_[slot];
+        // флаг pending ячейки пула меняет рабочий поток, поэтому он читается под мьютексом
+#ifndef _WIN32
+        if (backend_ == ASYNC_THREADS) {
+            pthread_mutex_lock(&mutex_);
+            while (request.pending) pthread_cond_wait(&done_, &mutex_);
+            pthread_mutex_unlock(&mutex_);
+            return request.result;
+        }
+#endif
+        if (!request.pending) return request.result;
+#ifdef EMPLOYEE_HAS_IO_URING
+        if (backend_ == ASYNC_URING) {
+            while (request.pending) {
+                if (!reapRing() && request.pending) waitRing();
+            }
+            // неполная передача дочитывается синхронно
+            if (request.result >= 0 && static_cast<size_t>(request.result) < request.size) {
+                long rest = transferAt(fd_, request.write, request.buffer + request.result,
+                                       request.size - request.result, request.offset + request.result);
+                request.result = rest < 0 ? -1 : request.result + rest;
+            }
+            return request.result;
+        }
+#endif
+        request.result = transferAt(fd_, request.write, request.buffer, request.size, request.offset);
+        request.pending = false;
+        return request.result;
+    }
+
+private:
+    AsyncIoQueue(const AsyncIoQueue&);
+    AsyncIoQueue& operator=(const AsyncIoQueue&);
+
+#ifndef _WIN32
+    static void* workerEntry(void* arg) {
+        static_cast<AsyncIoQueue*>(arg)->workerLoop();
+        return NULL;
+    }
+
+    void workerLoop() {
+        pthread_mutex_lock(&mutex_);
+        for (;;) {
+            while (!stop_ && queue_.empty()) pthread_cond_wait(&work_, &mutex_);
+            if (queue_.empty()) break;
+            size_t slot = queue_.front();
+            queue_.erase(queue_.begin());
+            pthread_mutex_unlock(&mutex_);
+            AsyncRequest& request = requests_[slot];
+            long result = transferAt(fd_, request.write, request.buffer, request.size, request.offset);
+            pthread_mutex_lock(&mutex_);
+            request.result = result;
+            request.pending = false;
+            pthread_cond_broadcast(&done_);
+        }
+        pthread_mutex_unlock(&mutex_);
+    }
+
+    bool startWorkers() {
+        stop_ = false;
+        pthread_mutex_init(&mutex_, NULL);
+        pthread_cond_init(&work_, NULL);
+        pthread_cond_init(&done_, NULL);
+        size_t count = requests_.size() < ASYNC_MAX_WORKERS ? requests_.size() : ASYNC_MAX_WORKERS;
+        for (size_t i = 0; i < count; i++) {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, workerEntry, this) != 0) break;
+            workers_.push_back(thread);
+        }
+        if (workers_.empty()) {
+            pthread_cond_destroy(&done_);
+            pthread_cond_destroy(&work_);
+            pthread_mutex_destroy(&mutex_);
+            return false;
+        }
+        return true;
+    }
+
+    void stopWorkers() {
+        if (workers_.empty()) return;
+        pthread_mutex_lock(&mutex_);
+        stop_ = true;
+        pthread_cond_broadcast(&work_);
+        pthread_mutex_unlock(&mutex_);
+        for (size_t i = 0; i < workers_.size(); i++) pthread_join(workers_[i], NULL);
+        workers_.clear();
+        pthread_cond_destroy(&done_);
+        pthread_cond_destroy(&work_);
+        pthread_mutex_destroy(&mutex_);
+    }
+#endif
+
+#ifdef EMPLOYEE_HAS_IO_URING
+    // Кольца io_uring через системные вызовы, без liburing: очередь отправки
+    // (sqRing_, sqes_) и очередь завершения (cqRing_) разделяются с ядром через mmap.
+    bool openRing() {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_ = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(requests_.size()), &params));
+        if (ring_ < 0) return false;
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single && cqRingSize_ > sqRingSize_) sqRingSize_ = cqRingSize_;
+        sqRing_ = mmapRing(sqRingSize_, IORING_OFF_SQ_RING);
+        cqRing_ = single ? sqRing_ : mmapRing(cqRingSize_, IORING_OFF_CQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        sqes_ = static_cast<struct io_uring_sqe*>(static_cast<void*>(mmapRing(sqesSize_, IORING_OFF_SQES)));
+        if (sqRing_ == NULL || cqRing_ == NULL || sqes_ == NULL) {
+            closeRing();
+            return false;
+        }
+        sqTail_ = reinterpret_cast<unsigned*>(sqRing_ + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned*>(sqRing_ + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sqRing_ + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(cqRing_ + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cqRing_ + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned*>(cqRing_ + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<struct io_uring_cqe*>(cqRing_ + params.cq_off.cqes);
+        return true;
+    }
+
+    char* mmapRing(size_t size, off_t offset) {
+        void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, offset);
+        return p == MAP_FAILED ? NULL : static_cast<char*>(p);
+    }
+
+    void closeRing() {
+        if (sqes_ != NULL) munmap(sqes_, sqesSize_);
+        if (cqRing_ != NULL && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+        if (sqRing_ != NULL) munmap(sqRing_, sqRingSize_);
+        if (ring_ >= 0) ::close(ring_);
+        ring_ = -1;
+        sqRing_ = cqRing_ = NULL;
+        sqes_ = NULL;
+    }
+
+    bool submitRing(size_t slot) {
+        AsyncRequest& request = requests_[slot];
+        request.iov.iov_base = request.buffer;
+        request.iov.iov_len = request.size;
+        unsigned tail = *sqTail_;
+        unsigned index = tail & *sqMask_;
+        struct io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = request.write ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe.fd = fd_;
+        sqe.addr = reinterpret_cast<uint64_t>(&request.iov);
+        sqe.len = 1;
+        sqe.off = request.offset;
+        sqe.user_data = slot;
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        if (syscall(__NR_io_uring_enter, ring_, 1, 0, 0, NULL, 0) < 0) {
+            // ядро не приняло запрос – выполняем его сразу
+            __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+            request.result = transferAt(fd_, request.write, request.buffer, request.size, request.offset);
+            request.pending = false;
+        }
+        return true;
+    }
+
+    // разбор завершенных запросов; true – завершился хотя бы один
+    bool reapRing() {
+        unsigned head = *cqHead_;
+        bool any = false;
+        while (head != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+            const struct io_uring_cqe& cqe = cqes_[head & *cqMask_];
+            AsyncRequest& request = requests_[static_cast<size_t>(cqe.user_data)];
+            request.result = cqe.res < 0 ? -1 : cqe.res;
+            request.pending = false;
+            head++;
+            any = true;
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        return any;
+    }
+
+    void waitRing() {
+        syscall(__NR_io_uring_enter, ring_, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    }
+#endif
+
+    int fd_;
+    AsyncBackend backend_;
+    std::vector<AsyncRequest> requests_;
+    bool stop_;
+#ifndef _WIN32
+    std::vector<pthread_t> workers_;
+    std::vector<size_t> queue_;
+    pthread_mutex_t mutex_;
+    pthread_cond_t work_;
+    pthread_cond_t done_;
+#endif
+#ifdef EMPLOYEE_HAS_IO_URING
+    int ring_;
+    char* sqRing_;
+    char* cqRing_;
+    struct io_uring_sqe* sqes_;
+    size_t sqRingSize_;
+    size_t cqRingSize_;
+    size_t sqesSize_;
+    unsigned* sqTail_;
+    unsigned* sqMask_;
+    unsigned* sqArray_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned* cqMask_;
+    struct io_uring_cqe* cqes_;
+#endif
+};
+
+inline int openAsyncFile(const char* filename, bool write)
+{
+#ifdef _WIN32
+    return write ? _open(filename, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE)
+                 : _open(filename, _O_RDONLY | _O_BINARY);
+#else
+    return write ? ::open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)
+                 : ::open(filename, O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+inline void closeAsyncFile(int fd)
+{
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+// Последовательное чтение файла блоками с опережением: после open() в очереди
+// уже depth блоков, и каждый возвращенный next() буфер сразу после следующего
+// вызова отправляется за очередным блоком.
+class AsyncFileReader {
+public:
+    AsyncFileReader() : fd_(-1), fileSize_(0), blockSize_(0), submitted_(0), consumed_(0), blocks_(0) {}
+    ~AsyncFileReader() { close(); }
+
+    bool open(const char* filename, AsyncBackend backend = ASYNC_AUTO,
+              size_t blockSize = ASYNC_BLOCK_SIZE, unsigned depth = ASYNC_READ_DEPTH) {
+        close();
+        fd_ = openAsyncFile(filename, false);
+        if (fd_ < 0) return false;
+#ifdef _WIN32
+        struct _stati64 st;
+        bool statOk = _fstati64(fd_, &st) == 0;
+#else
+        struct stat st;
+        bool statOk = fstat(fd_, &st) == 0;
+#endif
+        if (!statOk) {
+            close();
+            return false;
+        }
+        fileSize_ = static_cast<uint64_t>(st.st_size);
+        blockSize_ = blockSize > 0 ? blockSize : ASYNC_BLOCK_SIZE;
+        blocks_ = (fileSize_ + blockSize_ - 1) / blockSize_;
+        // для маленького файла столько ячеек, сколько в нем блоков
+        if (depth == 0) depth = 1;
+        if (blocks_ < depth) depth = blocks_ > 0 ? static_cast<unsigned>(blocks_) : 1;
+        buffers_.resize(depth);
+        for (size_t i = 0; i < depth; i++) buffers_[i].resize(blockSize_);
+        queue_.open(fd_, backend, depth);
+        submitted_ = consumed_ = 0;
+        while (submitted_ < blocks_ && submitted_ < depth) submitNext();
+        return true;
+    }
+
+    void close() {
+        queue_.close();
+        if (fd_ >= 0) closeAsyncFile(fd_);
+        fd_ = -1;
+        buffers_.clear();
+    }
+
+    uint64_t fileSize() const { return fileSize_; }
+    AsyncBackend backend() const { return queue_.backend(); }
+
+    // Следующий по порядку блок; буфер действителен до следующего вызова.
+    // В конце файла size == 0. false – ошибка чтения или файл укоротился.
+    bool next(const char*& data, size_t& size) {
+        // предыдущий буфер возвращен – отправляем его за следующим блоком
+        if (consumed_ > 0 && submitted_ < blocks_) submitNext();
+        data = NULL;
+        size = 0;
+        if (consumed_ >= blocks_) return true;
+        size_t slot = static_cast<size_t>(consumed_ % buffers_.size());
+        size_t expected = blockLength(consumed_);
+        long got = queue_.wait(slot);
+        if (got < 0 || static_cast<size_t>(got) != expected) return false;
+        data = &buffers_[slot][0];
+        size = expected;
+        consumed_++;
+        return true;
+    }
+
+private:
+    AsyncFileReader(const AsyncFileReader&);
+    AsyncFileReader& operator=(const AsyncFileReader&);
+
+    size_t blockLength(uint64_t block) const {
+        uint64_t offset = block * blockSize_;
+        return static_cast<size_t>(fileSize_ - offset < blockSize_ ? fileSize_ - offset : blockSize_);
+    }
+
+    void submitNext() {
+        size_t slot = static_cast<size_t>(submitted_ % buffers_.size());
+        queue_.submit(slot, false, &buffers_[slot][0], blockLength(submitted_), submitted_ * blockSize_);
+        submitted_++;
+    }
+
+    int fd_;
+    uint64_t fileSize_;
+    size_t blockSize_;
+    uint64_t submitted_;
+    uint64_t consumed_;
+    uint64_t blocks_;
+    std::vector<std::vector<char> > buffers_;
+    AsyncIoQueue queue_;
+};
+
+// Запись с двойной буферизацией: пока один буфер пишется на диск,
+// следующий заполняется данными.
+class AsyncFileWriter {
+public:
+    AsyncFileWriter() : fd_(-1), blockSize_(0), current_(0), used_(0), offset_(0), ok_(false) {
+        sizes_[0] = sizes_[1] = 0;
+    }
+    ~AsyncFileWriter() { close(); }
+
+    bool open(const char* filename, AsyncBackend backend = ASYNC_AUTO, size_t blockSize = ASYNC_BLOCK_SIZE) {
+        close();
+        fd_ = openAsyncFile(filename, true);
+        if (fd_ < 0) return false;
+        blockSize_ = blockSize > 0 ? blockSize : ASYNC_BLOCK_SIZE;
+        for (size_t i = 0; i < 2; i++) buffers_[i].resize(blockSize_);
+        queue_.open(fd_, backend, 2);
+        current_ = used_ = 0;
+        sizes_[0] = sizes_[1] = 0;
+        offset_ = 0;
+        ok_ = true;
+        return true;
+    }
+
+    AsyncBackend backend() const { return queue_.backend(); }
+
+    bool write(const void* data, size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (ok_ && size > 0) {
+            size_t take = blockSize_ - used_ < size ? blockSize_ - used_ : size;
+            std::memcpy(&buffers_[current_][used_], p, take);
+            used_ += take;
+            p += take;
+            size -= take;
+            if (used_ == blockSize_) submitCurrent();
+        }
+        return ok_;
+    }
+
+    bool close() {
+        if (fd_ < 0) return ok_;
+        if (ok_ && used_ > 0) submitCurrent();
+        for (size_t i = 0; i < 2; i++) complete(i);
+        queue_.close();
+        closeAsyncFile(fd_);
+        fd_ = -1;
+        return ok_;
+    }
+
+private:
+    AsyncFileWriter(const AsyncFileWriter&);
+    AsyncFileWriter& operator=(const AsyncFileWriter&);
+
+    void submitCurrent() {
+        queue_.submit(current_, true, &buffers_[current_][0], used_, offset_);
+        sizes_[current_] = used_;
+        offset_ += used_;
+        current_ ^= 1;
+        used_ = 0;
+        // второй буфер мог еще писаться – дожидаемся его перед заполнением
+        complete(current_);
+    }
+
+    // ожидание записи буфера slot, если он был отправлен
+    void complete(size_t slot) {
+        if (sizes_[slot] == 0) return;
+        long written = queue_.wait(slot);
+        if (written < 0 || static_cast<size_t>(written) != sizes_[slot]) ok_ = false;
+        sizes_[slot] = 0;
+    }
+
+    int fd_;
+    size_t blockSize_;
+    std::vector<char> buffers_[2];
+    size_t sizes_[2];
+    size_t current_;
+    size_t used_;
+    uint64_t offset_;
+    bool ok_;
+    AsyncIoQueue queue_;
+};
+
+// Чтение файла Employee через AsyncFileReader: блоки копируются в вектор и
+// учитываются в контрольной сумме, пока следующие блоки еще читаются.
+// Файлы других раскладок читает loadEmployeeRecords. На обоих путях записи
+// дописываются в конец employees, при ошибке вектор возвращается к прежнему размеру.
+inline bool readEmployeeRecordsAsync(const char* filename, std::vector<Employee>& employees,
+                                     EmployeeFileHeader* header = NULL, AsyncBackend backend = ASYNC_AUTO)
+{
+    AsyncFileReader reader;
+    if (!reader.open(filename, backend)) return false;
+    const char* data;
+    size_t size;
+    if (!reader.next(data, size)) return false;
+
+    EmployeeFileHeader fileHeader;
+    size_t dataOffset = 0;
+    if (hasEmployeeFileMagic(data, size)) {
+        std::memcpy(&fileHeader, data, sizeof(fileHeader));
+        if (!isSupportedEmployeeFileHeader(fileHeader)) return false;
+        if (fileHeader.format != EMPLOYEE_FORMAT_NATIVE) {
+            reader.close();
+            return loadEmployeeRecords(filename, employees, header);
+        }
+        dataOffset = sizeof(fileHeader);
+        // файл обрезан
+        if (fileHeader.recordCount > (reader.fileSize() - dataOffset) / sizeof(Employee)) return false;
+    } else {
+        // старый формат: неполная запись в конце отбрасывается
+        fileHeader = makeLegacyEmployeeFileHeader(reader.fileSize() / sizeof(Employee));
+    }
+
+    size_t first = employees.size();
+    size_t count = static_cast<size_t>(fileHeader.recordCount);
+    employees.resize(first + count);
+    char* out = count > 0 ? reinterpret_cast<char*>(&employees[first]) : NULL;
+    uint64_t total = static_cast<uint64_t>(count) * sizeof(Employee);
+    uint64_t position = 0;  // смещение начала блока в файле
+    uint64_t copied = 0;
+    EmployeeChecksum checksum;
+    bool ok = true;
+    while (ok && size > 0 && copied < total) {
+        uint64_t skip = position < dataOffset ? dataOffset - position : 0;
+        if (skip < size) {
+            size_t take = static_cast<size_t>(std::min<uint64_t>(size - skip, total - copied));
+            std::memcpy(out + copied, data + skip, take);
+            checksum.update(data + skip, take);
+            copied += take;
+        }
+        position += size;
+        if (copied < total) ok = reader.next(data, size);
+    }
+    if (!ok || copied != total || (fileHeader.version != 0 && checksum.value() != fileHeader.checksum)) {
+        employees.resize(first);
+        return false;
+    }
+    if (header != NULL) *header = fileHeader;
+    return true;
+}
+
+// запись файла Employee с заголовком через AsyncFileWriter
+inline bool writeEmployeeRecordsAsync(const char* filename, const std::vector<Employee>& employees,
+                                      AsyncBackend backend = ASYNC_AUTO)
+{
+    AsyncFileWriter writer;
+    if (!writer.open(filename, backend)) return false;
+    const Employee* data = employees.empty() ? NULL : &employees[0];
+    EmployeeFileHeader header = makeEmployeeFileHeader(data, employees.size());
+    bool ok = writer.write(&header, sizeof(header));
+    if (data != NULL) ok = ok && writer.write(data, employees.size() * sizeof(Employee));
+    return writer.close() && ok;
+}
+
+#endif // EMPLOYEE_ASYNC_IO_H
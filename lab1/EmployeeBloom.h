@@ -0,0 +1,278 @@
+#ifndef EMPLOYEE_BLOOM_H
+#define EMPLOYEE_BLOOM_H
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Employee.h"
+#include "EmployeeColumns.h"
+#include "EmployeeFileReader.h"
+#include "EmployeeFileView.h"
+
+// Фильтр Блума по id бинарного файла (файл <имя>.bloom): заголовок
+// EmployeeBloomHeader, затем blockCount блоков по 64 байта. Все биты одного
+// id лежат в одном блоке, поэтому проверка отсутствия id читает одну
+// строку кэша. При BLOOM_BITS_PER_ID битах на id ложных срабатываний около 1%
+// (проверяется в testEmployeeBloom).
+const char EMPLOYEE_BLOOM_MAGIC[4] = { 'E', 'B', 'L', 'M' };
+const uint16_t EMPLOYEE_BLOOM_VERSION = 2;
+const size_t BLOOM_BLOCK_WORDS = 8;  // 512 бит
+const uint16_t BLOOM_HASH_COUNT = 7;
+const uint64_t BLOOM_BITS_PER_ID = 10;
+
+// 64 байта, чтобы блоки в отображенном файле совпадали со строками кэша
+struct EmployeeBloomHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t hashCount;
+    uint32_t fileVersion;     // версия заголовка файла, 0 – файл без заголовка
+    uint32_t reserved;
+    uint64_t blockCount;
+    uint64_t fileRecordCount; // число записей в файле при построении фильтра
+    uint64_t fileChecksum;    // контрольная сумма из заголовка файла
+    uint64_t fileSize;        // размер и время изменения файла, как в заголовке индекса
+    uint64_t fileModified;
+    uint64_t padding;
+};
+
+inline std::string employeeBloomFilename(const char* binFilename)
+{
+    return std::string(binFilename) + ".bloom";
+}
+
+// шаг splitmix64
+inline uint64_t employeeBloomMix(uint64_t h)
+{
+    h += 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+// хеш id; по нему выбирается блок
+inline uint64_t employeeBloomHash(int num)
+{
+    return employeeBloomMix(static_cast<uint64_t>(static_cast<uint32_t>(num)));
+}
+
+// Маска id в блоке: по 9 бит на каждый из hashCount бит берутся из второго
+// раунда перемешивания, а не из хеша, выбравшего блок, – иначе при малом
+// числе блоков положение битов зависело бы от номера блока.
+inline void employeeBloomMask(uint64_t hash, unsigned hashCount, uint64_t mask[BLOOM_BLOCK_WORDS])
+{
+    std::memset(mask, 0, BLOOM_BLOCK_WORDS * sizeof(uint64_t));
+    uint64_t bits = employeeBloomMix(hash);
+    for (unsigned i = 0; i < hashCount; i++) {
+        unsigned bit = static_cast<unsigned>(bits & 511);
+        mask[bit >> 6] |= static_cast<uint64_t>(1) << (bit & 63);
+        bits >>= 9;
+    }
+}
+
+inline uint64_t employeeBloomBlock(uint64_t hash, uint64_t blockCount)
+{
+    return hash % blockCount;
+}
+
+// установка битов id в блоках words
+inline void addEmployeeBloomId(uint64_t* words, uint64_t blockCount, unsigned hashCount, int num)
+{
+    uint64_t hash = employeeBloomHash(num);
+    uint64_t mask[BLOOM_BLOCK_WORDS];
+    employeeBloomMask(hash, hashCount, mask);
+    uint64_t* block = words + employeeBloomBlock(hash, blockCount) * BLOOM_BLOCK_WORDS;
+    for (size_t w = 0; w < BLOOM_BLOCK_WORDS; w++) block[w] |= mask[w];
+}
+
+inline void setEmployeeBloomStamp(EmployeeBloomHeader& header, const EmployeeFileStamp& stamp)
+{
+    header.fileVersion = stamp.version;
+    header.fileRecordCount = stamp.recordCount;
+    header.fileChecksum = stamp.checksum;
+    header.fileSize = stamp.size;
+    header.fileModified = stamp.modified;
+}
+
+// построение фильтра в памяти для ожидаемого числа id
+class EmployeeBloomBuilder {
+public:
+    explicit EmployeeBloomBuilder(uint64_t expected) {
+        uint64_t blocks = (expected * BLOOM_BITS_PER_ID + BLOOM_BLOCK_WORDS * 64 - 1) / (BLOOM_BLOCK_WORDS * 64);
+        blockCount_ = blocks > 0 ? blocks : 1;
+        words_.assign(static_cast<size_t>(blockCount_ * BLOOM_BLOCK_WORDS), 0);
+    }
+
+    void add(int num) { addEmployeeBloomId(&words_[0], blockCount_, BLOOM_HASH_COUNT, num); }
+
+    void add(const int* nums, size_t count) {
+        for (size_t i = 0; i < count; i++) add(nums[i]);
+    }
+
+    void add(const Employee* employees, size_t count) {
+        for (size_t i = 0; i < count; i++) add(employees[i].num);
+    }
+
+    // запись фильтра с заголовком по состоянию файла stamp
+    bool write(const char* bloomFilename, const EmployeeFileStamp& stamp) const {
+        EmployeeBloomHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, EMPLOYEE_BLOOM_MAGIC, sizeof(header.magic));
+        header.version = EMPLOYEE_BLOOM_VERSION;
+        header.hashCount = BLOOM_HASH_COUNT;
+        header.blockCount = blockCount_;
+        setEmployeeBloomStamp(header, stamp);
+
+        std::ofstream ofs(bloomFilename, std::ios::binary);
+        if (!ofs) return false;
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ofs.write(reinterpret_cast<const char*>(&words_[0]), words_.size() * sizeof(uint64_t));
+        return ofs.good();
+    }
+
+private:
+    uint64_t blockCount_;
+    std::vector<uint64_t> words_;
+};
+
+// построение фильтра по отображенному файлу
+inline bool buildEmployeeBloom(const EmployeeFileView& view, const char* bloomFilename)
+{
+    EmployeeBloomBuilder builder(view.size());
+    builder.add(view.data(), view.size());
+    return builder.write(bloomFilename, view.stamp());
+}
+
+// Построение фильтра по файлу любой раскладки: записи Employee берутся из
+// отображения, колоночный файл – из колонки id, остальные читаются потоком.
+inline bool buildEmployeeBloom(const char* binFilename, const char* bloomFilename)
+{
+    EmployeeFileView view;
+    if (view.open(binFilename)) return buildEmployeeBloom(view, bloomFilename);
+    EmployeeColumnView columns;
+    if (columns.open(binFilename)) {
+        EmployeeBloomBuilder builder(columns.size());
+        builder.add(columns.num(), columns.size());
+        return builder.write(bloomFilename, makeEmployeeFileStamp(columns.header(), columns.size(), 0, 0));
+    }
+    EmployeeFileReader reader;
+    if (!reader.open(binFilename) || reader.header().recordCount == EMPLOYEE_COUNT_UNKNOWN) return false;
+    EmployeeBloomBuilder builder(reader.header().recordCount);
+    for (const Employee* emp = reader.next(); emp != NULL; emp = reader.next()) builder.add(emp->num);
+    // раскладки, кроме Employee, бывают только с заголовком: размер и время не нужны
+    return reader.ok() &&
+           builder.write(bloomFilename, makeEmployeeFileStamp(reader.header(), reader.header().recordCount, 0, 0));
+}
+
+// Отображенный в память фильтр. Открытый через openForUpdate фильтр
+// дополняется новыми id на месте: меняются только их блоки и заголовок.
+class EmployeeBloom {
+public:
+    EmployeeBloom() : words_(NULL) {}
+
+    bool open(const char* bloomFilename) { return map(bloomFilename, false); }
+
+    bool openForUpdate(const char* bloomFilename) { return map(bloomFilename, true); }
+
+    void close() {
+        file_.close();
+        words_ = NULL;
+    }
+
+    // построен ли фильтр по текущему содержимому файла
+    bool matches(const EmployeeFileStamp& stamp) const {
+        return file_.isOpen() && sameEmployeeFileStamp(this->stamp(), stamp);
+    }
+
+    bool matches(const EmployeeFileView& view) const { return matches(view.stamp()); }
+
+    // состояние файла, по которому построен фильтр
+    EmployeeFileStamp stamp() const {
+        EmployeeFileStamp stamp;
+        stamp.version = header_.fileVersion;
+        stamp.recordCount = header_.fileRecordCount;
+        stamp.checksum = header_.fileChecksum;
+        stamp.size = header_.fileSize;
+        stamp.modified = header_.fileModified;
+        return stamp;
+    }
+
+    // false – id в файле точно нет, true – id, вероятно, есть
+    bool mayContain(int num) const {
+        uint64_t hash = employeeBloomHash(num);
+        uint64_t mask[BLOOM_BLOCK_WORDS];
+        employeeBloomMask(hash, header_.hashCount, mask);
+        const uint64_t* block = words_ + employeeBloomBlock(hash, header_.blockCount) * BLOOM_BLOCK_WORDS;
+        for (size_t w = 0; w < BLOOM_BLOCK_WORDS; w++) {
+            if ((block[w] & mask[w]) != mask[w]) return false;
+        }
+        return true;
+    }
+
+    // сколько id фильтр вмещает при BLOOM_BITS_PER_ID битах на id
+    uint64_t capacity() const { return header_.blockCount * BLOOM_BLOCK_WORDS * 64 / BLOOM_BITS_PER_ID; }
+
+    // только для фильтра, открытого через openForUpdate
+    void add(int num) {
+        uint64_t* words = reinterpret_cast<uint64_t*>(file_.writableData() + sizeof(header_));
+        addEmployeeBloomId(words, header_.blockCount, header_.hashCount, num);
+    }
+
+    void add(const Employee* employees, size_t count) {
+        for (size_t i = 0; i < count; i++) add(employees[i].num);
+    }
+
+    // новое состояние файла после добавления id; заголовок меняется последним
+    void setStamp(const EmployeeFileStamp& stamp) {
+        setEmployeeBloomStamp(header_, stamp);
+        std::memcpy(file_.writableData(), &header_, sizeof(header_));
+    }
+
+private:
+    EmployeeBloom(const EmployeeBloom&);
+    EmployeeBloom& operator=(const EmployeeBloom&);
+
+    bool map(const char* bloomFilename, bool writable) {
+        words_ = NULL;
+        if (!(writable ? file_.openForUpdate(bloomFilename) : file_.open(bloomFilename))) return false;
+        if (file_.size() < sizeof(header_) ||
+            std::memcmp(file_.data(), EMPLOYEE_BLOOM_MAGIC, sizeof(EMPLOYEE_BLOOM_MAGIC)) != 0) {
+            file_.close();
+            return false;
+        }
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if (header_.version != EMPLOYEE_BLOOM_VERSION || header_.hashCount == 0 || header_.hashCount > 7 ||
+            header_.blockCount == 0 ||
+            header_.blockCount > (file_.size() - sizeof(header_)) / (BLOOM_BLOCK_WORDS * sizeof(uint64_t))) {
+            file_.close();
+            return false;
+        }
+        words_ = reinterpret_cast<const uint64_t*>(file_.data() + sizeof(header_));
+        return true;
+    }
+
+    MappedFile file_;
+    EmployeeBloomHeader header_;
+    const uint64_t* words_;
+};
+
+// Необязательный фильтр рядом с только что записанным файлом (флаг --bloom
+// утилит). Ошибка построения не портит сам файл, поэтому о ней только
+// предупреждают; фильтр, который уже совпадает с файлом (например, обновлен
+// при дописывании), не перестраивается.
+inline void buildEmployeeBloomSidecar(const char* binFilename, std::ostream& warnings)
+{
+    std::string bloomFilename = employeeBloomFilename(binFilename);
+    {
+        EmployeeFileView view;
+        EmployeeBloom bloom;
+        if (view.open(binFilename) && bloom.open(bloomFilename.c_str()) && bloom.matches(view)) return;
+    }
+    if (!buildEmployeeBloom(binFilename, bloomFilename.c_str())) {
+        warnings << "Предупреждение: фильтр Блума " << bloomFilename << " не построен." << std::endl;
+    }
+}
+
+#endif // EMPLOYEE_BLOOM_H
@@ -0,0 +1,167 @@
+#ifndef EMPLOYEE_COLUMNS_H
+#define EMPLOYEE_COLUMNS_H
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "Employee.h"
+#include "EmployeeFileView.h"
+
+// сотрудники в виде отдельных колонок (структура массивов)
+struct EmployeeColumns {
+    std::vector<int> num;
+    std::vector<char> names;    // по 10 байт на сотрудника
+    std::vector<double> hours;
+
+    size_t size() const { return num.size(); }
+    const char* name(size_t i) const { return &names[i * 10]; }
+
+    void resize(size_t count) {
+        num.resize(count);
+        names.resize(count * 10);
+        hours.resize(count);
+    }
+
+    void assign(const Employee* employees, size_t count) {
+        resize(count);
+        for (size_t i = 0; i < count; i++) {
+            num[i] = employees[i].num;
+            std::memcpy(&names[i * 10], employees[i].name, 10);
+            hours[i] = employees[i].hours;
+        }
+    }
+
+    Employee at(size_t i) const {
+        Employee emp;
+        std::memset(&emp, 0, sizeof(emp));
+        emp.num = num[i];
+        std::memcpy(emp.name, name(i), 10);
+        emp.hours = hours[i];
+        return emp;
+    }
+};
+
+// запись колонок в файл колоночной раскладки: каждая колонка – одной записью в поток
+inline bool writeEmployeeColumns(const char* filename, const EmployeeColumns& columns)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) return false;
+    size_t count = columns.size();
+    EmployeeColumnLayout layout = employeeColumnLayout(count);
+    EmployeeFileHeader header = makeEmptyEmployeeFileHeader(EMPLOYEE_FORMAT_COLUMNAR);
+    header.flags = count == 0 || isSortedIds(&columns.num[0], count) ? EMPLOYEE_FLAG_SORTED : 0;
+    header.recordCount = count;
+    EmployeeChecksum checksum;
+    if (count > 0) {
+        checksum.update(&columns.num[0], count * sizeof(int));
+        checksum.update(&columns.names[0], count * 10);
+        checksum.update(&columns.hours[0], count * sizeof(double));
+    }
+    header.checksum = checksum.value();
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (count > 0) {
+        ofs.write(reinterpret_cast<const char*>(&columns.num[0]), count * sizeof(int));
+        ofs.write(&columns.names[0], count * 10);
+        ofs.write("\0\0\0\0\0\0\0", static_cast<std::streamsize>(layout.hoursOffset - layout.namesOffset - count * 10));
+        ofs.write(reinterpret_cast<const char*>(&columns.hours[0]), count * sizeof(double));
+    }
+    return ofs.good();
+}
+
+// Отображенный в память файл колоночной раскладки: колонки доступны
+// как обычные массивы без копирования.
+class EmployeeColumnView {
+public:
+    EmployeeColumnView() : count_(0) {}
+
+    bool open(const char* filename) {
+        count_ = 0;
+        if (!file_.open(filename)) return false;
+        if (!hasEmployeeFileMagic(file_.data(), file_.size())) {
+            file_.close();
+            return false;
+        }
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if (!isSupportedEmployeeFileHeader(header_) || header_.format != EMPLOYEE_FORMAT_COLUMNAR ||
+            header_.recordCount > file_.size() / COLUMNAR_EMPLOYEE_SIZE ||
+            employeeColumnLayout(header_.recordCount).end > file_.size()) {
+            file_.close();
+            return false;
+        }
+        count_ = static_cast<size_t>(header_.recordCount);
+        layout_ = employeeColumnLayout(count_);
+        return true;
+    }
+
+    size_t size() const { return count_; }
+    const EmployeeFileHeader& header() const { return header_; }
+    bool sorted() const { return (header_.flags & EMPLOYEE_FLAG_SORTED) != 0; }
+    const int* num() const { return reinterpret_cast<const int*>(file_.data() + layout_.numOffset); }
+    const char* name(size_t i) const { return file_.data() + layout_.namesOffset + i * 10; }
+    const double* hours() const { return reinterpret_cast<const double*>(file_.data() + layout_.hoursOffset); }
+
+    bool verifyChecksum() const {
+        EmployeeChecksum checksum;
+        checksum.update(file_.data() + layout_.numOffset, count_ * sizeof(int));
+        checksum.update(file_.data() + layout_.namesOffset, count_ * 10);
+        checksum.update(file_.data() + layout_.hoursOffset, count_ * sizeof(double));
+        return checksum.value() == header_.checksum;
+    }
+
+    // Проверка суммы с передачей колонки часов блоками в sink.addHours(hours, count)
+    // за тот же проход; если сумма не сошлась, результат sink надо отбросить.
+    template <class Sink>
+    bool verifyChecksum(Sink& sink) const {
+        EmployeeChecksum checksum;
+        checksum.update(file_.data() + layout_.numOffset, count_ * sizeof(int));
+        checksum.update(file_.data() + layout_.namesOffset, count_ * 10);
+        const double* column = hours();
+        for (size_t first = 0; first < count_; first += VIEW_BLOCK_RECORDS) {
+            size_t n = std::min(VIEW_BLOCK_RECORDS, count_ - first);
+            checksum.update(column + first, n * sizeof(double));
+            sink.addHours(column + first, n);
+        }
+        return checksum.value() == header_.checksum;
+    }
+
+private:
+    EmployeeColumnView(const EmployeeColumnView&);
+    EmployeeColumnView& operator=(const EmployeeColumnView&);
+
+    MappedFile file_;
+    EmployeeFileHeader header_;
+    EmployeeColumnLayout layout_;
+    size_t count_;
+};
+
+// Чтение колонок из файла любой раскладки: колоночный файл читается
+// по колонке за вызов, остальные раскладки переводятся из записей.
+inline bool readEmployeeColumns(const char* filename, EmployeeColumns& columns)
+{
+    EmployeeColumnView view;
+    if (view.open(filename)) {
+        if (!view.verifyChecksum()) return false;
+        size_t count = view.size();
+        columns.resize(count);
+        if (count > 0) {
+            std::memcpy(&columns.num[0], view.num(), count * sizeof(int));
+            std::memcpy(&columns.names[0], view.name(0), count * 10);
+            std::memcpy(&columns.hours[0], view.hours(), count * sizeof(double));
+        }
+        return true;
+    }
+    std::vector<Employee> employees;
+    if (!readEmployeeRecords(filename, employees)) return false;
+    columns.assign(employees.empty() ? NULL : &employees[0], employees.size());
+    return true;
+}
+
+// зарплата каждого сотрудника по колонке часов
+inline void computeSalaries(const double* hours, size_t count, double hourlyRate, double* salaries)
+{
+    for (size_t i = 0; i < count; i++) salaries[i] = hours[i] * hourlyRate;
+}
+
+#endif // EMPLOYEE_COLUMNS_H
@@ -0,0 +1,337 @@
+#ifndef EMPLOYEE_COMPRESSION_H
+#define EMPLOYEE_COMPRESSION_H
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "Employee.h"
+#include "Parallel.h"
+
+// Сжатая раскладка (EMPLOYEE_FORMAT_COMPRESSED): после заголовка идут блоки
+// по COMPRESSED_BLOCK записей, каждый раскодируется независимо от остальных,
+// затем каталог блоков (по CompressedBlockEntry на блок) и 8 байт – смещение
+// каталога от начала файла. Все числа в little-endian. Контрольная сумма
+// заголовка считается по байтам блоков.
+//
+// Блок: varint число записей; id – zigzag-varint первого id и разностей соседних;
+// словарь имен блока (varint размер, затем байт длины и символы каждого имени)
+// и varint номер имени на запись; байт режима часов и часы: 0 – zigzag-varint
+// сотых долей, если это значение восстанавливается точно, 1 – 8 байт IEEE 754.
+const size_t COMPRESSED_BLOCK = 65536;
+
+struct CompressedBlockEntry {
+    uint64_t offset;  // смещение блока от начала файла
+    uint32_t count;   // записей в блоке
+    uint32_t size;    // байтов в блоке
+};
+const size_t COMPRESSED_ENTRY_SIZE = 16;
+
+inline void putVarint(std::vector<unsigned char>& out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+inline bool getVarint(const unsigned char*& p, const unsigned char* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p == end) return false;
+        unsigned char byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzagEncode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline void putLittleEndian(std::vector<unsigned char>& out, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++) out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+inline uint64_t getLittleEndian(const unsigned char* p, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return value;
+}
+
+// часы в сотых долях, если значение восстанавливается из них бит в бит
+inline bool hoursToCents(double hours, int64_t& cents)
+{
+    if (!(std::fabs(hours) < 1e15)) return false;
+    cents = static_cast<int64_t>(std::floor(hours * 100 + 0.5));
+    double restored = static_cast<double>(cents) / 100;
+    return std::memcmp(&restored, &hours, sizeof(hours)) == 0;
+}
+
+inline void encodeEmployeeBlock(const Employee* employees, size_t count, std::vector<unsigned char>& out)
+{
+    out.clear();
+    putVarint(out, count);
+    int64_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        putVarint(out, zigzagEncode(static_cast<int64_t>(employees[i].num) - previous));
+        previous = employees[i].num;
+    }
+
+    // словарь имен в порядке первого появления
+    std::map<std::string, uint32_t> dictionary;
+    std::vector<const std::string*> names;
+    std::vector<uint32_t> nameIndex(count);
+    for (size_t i = 0; i < count; i++) {
+        const char* name = employees[i].name;
+        size_t length = 0;
+        while (length < sizeof(employees[i].name) && name[length] != '\0') length++;
+        std::pair<std::map<std::string, uint32_t>::iterator, bool> inserted =
+            dictionary.insert(std::make_pair(std::string(name, length), static_cast<uint32_t>(names.size())));
+        if (inserted.second) names.push_back(&inserted.first->first);
+        nameIndex[i] = inserted.first->second;
+    }
+    putVarint(out, names.size());
+    for (size_t k = 0; k < names.size(); k++) {
+        out.push_back(static_cast<unsigned char>(names[k]->size()));
+        out.insert(out.end(), names[k]->begin(), names[k]->end());
+    }
+    for (size_t i = 0; i < count; i++) putVarint(out, nameIndex[i]);
+
+    bool fixedPoint = true;
+    std::vector<int64_t> cents(count);
+    for (size_t i = 0; fixedPoint && i < count; i++) fixedPoint = hoursToCents(employees[i].hours, cents[i]);
+    out.push_back(fixedPoint ? 0 : 1);
+    for (size_t i = 0; i < count; i++) {
+        if (fixedPoint) {
+            putVarint(out, zigzagEncode(cents[i]));
+        } else {
+            uint64_t bits;
+            std::memcpy(&bits, &employees[i].hours, sizeof(bits));
+            putLittleEndian(out, bits, 8);
+        }
+    }
+}
+
+// раскодирование блока ровно из count записей; false – блок поврежден
+inline bool decodeEmployeeBlock(const unsigned char* data, size_t size, Employee* out, size_t count)
+{
+    const unsigned char* p = data;
+    const unsigned char* end = data + size;
+    uint64_t value;
+    if (!getVarint(p, end, value) || value != count) return false;
+    int64_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!getVarint(p, end, value)) return false;
+        previous += zigzagDecode(value);
+        std::memset(&out[i], 0, sizeof(Employee));
+        out[i].num = static_cast<int>(previous);
+    }
+
+    uint64_t dictionarySize;
+    if (!getVarint(p, end, dictionarySize) || dictionarySize > count) return false;
+    std::vector<const unsigned char*> names(static_cast<size_t>(dictionarySize));
+    std::vector<size_t> lengths(names.size());
+    for (size_t k = 0; k < names.size(); k++) {
+        if (p == end) return false;
+        lengths[k] = *p++;
+        if (lengths[k] > sizeof(out[0].name) || static_cast<size_t>(end - p) < lengths[k]) return false;
+        names[k] = p;
+        p += lengths[k];
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!getVarint(p, end, value) || value >= names.size()) return false;
+        std::memcpy(out[i].name, names[static_cast<size_t>(value)], lengths[static_cast<size_t>(value)]);
+    }
+
+    if (p == end) return false;
+    unsigned char mode = *p++;
+    if (mode == 0) {
+        for (size_t i = 0; i < count; i++) {
+            if (!getVarint(p, end, value)) return false;
+            out[i].hours = static_cast<double>(zigzagDecode(value)) / 100;
+        }
+    } else if (mode == 1) {
+        if (static_cast<size_t>(end - p) < count * 8) return false;
+        for (size_t i = 0; i < count; i++, p += 8) {
+            uint64_t bits = getLittleEndian(p, 8);
+            std::memcpy(&out[i].hours, &bits, sizeof(bits));
+        }
+    } else {
+        return false;
+    }
+    return p == end;
+}
+
+struct CompressionRound {
+    const Employee* employees;
+    size_t count;
+    size_t firstBlock;
+    std::vector<unsigned char>* blocks;
+};
+
+inline void encodeBlockTask(void* arg, size_t index)
+{
+    CompressionRound* round = static_cast<CompressionRound*>(arg);
+    size_t first = (round->firstBlock + index) * COMPRESSED_BLOCK;
+    round->blocks[index].clear();
+    if (first >= round->count) return;
+    size_t count = std::min(COMPRESSED_BLOCK, round->count - first);
+    encodeEmployeeBlock(round->employees + first, count, round->blocks[index]);
+}
+
+// Запись сжатого файла: блоки кодируются параллельно раундами по threads блоков
+// (0 – по числу процессоров) и записываются по порядку.
+inline bool writeEmployeeCompressed(const char* filename, const Employee* employees, size_t count,
+                                    unsigned threads = 0)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) return false;
+    if (threads == 0) threads = hardwareThreadCount();
+    EmployeeFileHeader header = makeEmptyEmployeeFileHeader(EMPLOYEE_FORMAT_COMPRESSED);
+    header.flags = isSortedById(employees, count) ? EMPLOYEE_FLAG_SORTED : 0;
+    header.recordCount = count;
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<std::vector<unsigned char> > blocks(threads);
+    std::vector<unsigned char> directory;
+    EmployeeChecksum checksum;
+    uint64_t offset = sizeof(header);
+    size_t blockCount = (count + COMPRESSED_BLOCK - 1) / COMPRESSED_BLOCK;
+    CompressionRound round;
+    round.employees = employees;
+    round.count = count;
+    round.blocks = &blocks[0];
+    for (round.firstBlock = 0; round.firstBlock < blockCount; round.firstBlock += threads) {
+        runParallel(static_cast<unsigned>(std::min<size_t>(threads, blockCount - round.firstBlock)),
+                    encodeBlockTask, &round);
+        for (size_t t = 0; t < threads && round.firstBlock + t < blockCount; t++) {
+            const std::vector<unsigned char>& block = blocks[t];
+            size_t records = std::min(COMPRESSED_BLOCK, count - (round.firstBlock + t) * COMPRESSED_BLOCK);
+            putLittleEndian(directory, offset, 8);
+            putLittleEndian(directory, records, 4);
+            putLittleEndian(directory, block.size(), 4);
+            checksum.update(&block[0], block.size());
+            ofs.write(reinterpret_cast<const char*>(&block[0]), block.size());
+            offset += block.size();
+        }
+    }
+    if (!directory.empty()) ofs.write(reinterpret_cast<const char*>(&directory[0]), directory.size());
+    std::vector<unsigned char> trailer;
+    putLittleEndian(trailer, offset, 8);
+    ofs.write(reinterpret_cast<const char*>(&trailer[0]), trailer.size());
+
+    header.checksum = checksum.value();
+    ofs.seekp(0, std::ios::beg);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return ofs.good();
+}
+
+struct DecompressionState {
+    const unsigned char* data;
+    std::vector<CompressedBlockEntry> blocks;
+    std::vector<size_t> firstRecord;
+    Employee* out;
+    std::vector<char> failed;
+    unsigned threads;
+};
+
+inline void decodeBlockTask(void* arg, size_t index)
+{
+    DecompressionState* state = static_cast<DecompressionState*>(arg);
+    for (size_t b = index; b < state->blocks.size(); b += state->threads) {
+        const CompressedBlockEntry& entry = state->blocks[b];
+        state->failed[b] = !decodeEmployeeBlock(state->data + entry.offset, entry.size,
+                                                state->out + state->firstRecord[b], entry.count);
+    }
+}
+
+// есть ли у файла заголовок сжатой раскладки
+inline bool isCompressedEmployeeFile(const char* filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    EmployeeFileHeader header;
+    return ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+           hasEmployeeFileMagic(&header, sizeof(header)) && header.format == EMPLOYEE_FORMAT_COMPRESSED;
+}
+
+// Чтение сжатого файла: файл читается в память целиком, блоки раскодируются
+// параллельно в threads потоков (0 – по числу процессоров) и дописываются к employees.
+inline bool readEmployeeCompressed(const char* filename, std::vector<Employee>& employees,
+                                   EmployeeFileHeader* header = NULL, unsigned threads = 0)
+{
+    std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+    if (!ifs) return false;
+    uint64_t fileSize = static_cast<uint64_t>(ifs.tellg());
+    if (fileSize < sizeof(EmployeeFileHeader) + 8) return false;
+    std::vector<unsigned char> bytes(static_cast<size_t>(fileSize));
+    ifs.seekg(0, std::ios::beg);
+    if (!ifs.read(reinterpret_cast<char*>(&bytes[0]), bytes.size())) return false;
+
+    EmployeeFileHeader fileHeader;
+    std::memcpy(&fileHeader, &bytes[0], sizeof(fileHeader));
+    if (!hasEmployeeFileMagic(&fileHeader, sizeof(fileHeader)) || !isSupportedEmployeeFileHeader(fileHeader) ||
+        fileHeader.format != EMPLOYEE_FORMAT_COMPRESSED) {
+        return false;
+    }
+    uint64_t directoryOffset = getLittleEndian(&bytes[bytes.size() - 8], 8);
+    if (directoryOffset < sizeof(fileHeader) || directoryOffset > fileSize - 8 ||
+        (fileSize - 8 - directoryOffset) % COMPRESSED_ENTRY_SIZE != 0) {
+        return false;
+    }
+
+    DecompressionState state;
+    state.data = &bytes[0];
+    size_t blockCount = static_cast<size_t>((fileSize - 8 - directoryOffset) / COMPRESSED_ENTRY_SIZE);
+    state.blocks.resize(blockCount);
+    state.firstRecord.resize(blockCount);
+    uint64_t total = 0, expectedOffset = sizeof(fileHeader);
+    for (size_t b = 0; b < blockCount; b++) {
+        const unsigned char* p = &bytes[static_cast<size_t>(directoryOffset) + b * COMPRESSED_ENTRY_SIZE];
+        CompressedBlockEntry& entry = state.blocks[b];
+        entry.offset = getLittleEndian(p, 8);
+        entry.count = static_cast<uint32_t>(getLittleEndian(p + 8, 4));
+        entry.size = static_cast<uint32_t>(getLittleEndian(p + 12, 4));
+        // блоки идут подряд от заголовка до каталога
+        if (entry.offset != expectedOffset || entry.size > directoryOffset - entry.offset) return false;
+        expectedOffset += entry.size;
+        state.firstRecord[b] = static_cast<size_t>(total);
+        total += entry.count;
+    }
+    if (expectedOffset != directoryOffset || total != fileHeader.recordCount) return false;
+    if (employeeChecksum(&bytes[sizeof(fileHeader)], static_cast<size_t>(directoryOffset - sizeof(fileHeader))) !=
+        fileHeader.checksum) {
+        return false;
+    }
+
+    size_t first = employees.size();
+    employees.resize(first + static_cast<size_t>(total));
+    state.out = total > 0 ? &employees[first] : NULL;
+    state.failed.assign(blockCount, 0);
+    if (threads == 0) threads = hardwareThreadCount();
+    state.threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, blockCount)));
+    runParallel(state.threads, decodeBlockTask, &state);
+    for (size_t b = 0; b < blockCount; b++) {
+        if (state.failed[b]) {
+            employees.resize(first);
+            return false;
+        }
+    }
+    if (header != NULL) *header = fileHeader;
+    return true;
+}
+
+#endif // EMPLOYEE_COMPRESSION_H
@@ -0,0 +1,231 @@
+#ifndef EMPLOYEE_FILE_READER_H
+#define EMPLOYEE_FILE_READER_H
+
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "Employee.h"
+#include "EmployeeCompression.h"
+
+// размер буфера записей по умолчанию
+const size_t EMPLOYEE_READER_BUFFER = 1 << 20;
+
+// Потоковое чтение файла сотрудников через буфер постоянного размера:
+// записи выдаются по ссылке на буфер, который переиспользуется при каждом
+// дочитывании, поэтому память не зависит от размера файла.
+// Поддерживаются построчные раскладки, файл без заголовка, сжатый файл
+// (по блоку до COMPRESSED_BLOCK записей) и стандартный ввод "-".
+// Колоночный файл построчно не читается – для него есть EmployeeColumnView.
+// Обрезанный файл и несовпадение контрольной суммы обнаруживаются только
+// в конце: next() возвращает NULL, а ok() – false.
+class EmployeeFileReader {
+public:
+    // однопроходный итератор; begin() продолжает чтение с текущего места
+    class const_iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Employee value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Employee* pointer;
+        typedef const Employee& reference;
+
+        const_iterator() : reader_(NULL), current_(NULL) {}
+        const_iterator(EmployeeFileReader* reader, const Employee* current) : reader_(reader), current_(current) {}
+
+        reference operator*() const { return *current_; }
+        pointer operator->() const { return current_; }
+        const_iterator& operator++() {
+            current_ = reader_->next();
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const { return current_ == other.current_; }
+        bool operator!=(const const_iterator& other) const { return current_ != other.current_; }
+
+    private:
+        EmployeeFileReader* reader_;
+        const Employee* current_;
+    };
+
+    EmployeeFileReader() : is_(NULL), pos_(0), len_(0), remaining_(0), prefixSize_(0), block_(0), ok_(false) {}
+    explicit EmployeeFileReader(const char* filename, size_t bufferBytes = EMPLOYEE_READER_BUFFER)
+        : is_(NULL), pos_(0), len_(0), remaining_(0), prefixSize_(0), block_(0), ok_(false) {
+        open(filename, bufferBytes);
+    }
+
+    bool open(const char* filename, size_t bufferBytes = EMPLOYEE_READER_BUFFER) {
+        close();
+        bool fromStdin = std::strcmp(filename, "-") == 0;
+        if (fromStdin) {
+            is_ = &std::cin;
+        } else {
+            ifs_.open(filename, std::ios::binary);
+            if (!ifs_) return false;
+            is_ = &ifs_;
+        }
+        // в буфер должны поместиться байты заголовка, если он окажется началом записей
+        buffer_.resize(std::max<size_t>(bufferBytes / sizeof(Employee), 2));
+
+        is_->read(reinterpret_cast<char*>(&header_), sizeof(header_));
+        size_t prefix = static_cast<size_t>(is_->gcount());
+        if (prefix == sizeof(header_) && hasEmployeeFileMagic(&header_, sizeof(header_))) {
+            if (!isSupportedEmployeeFileHeader(header_) || header_.format == EMPLOYEE_FORMAT_COLUMNAR) {
+                close();
+                return false;
+            }
+            if (header_.format == EMPLOYEE_FORMAT_COMPRESSED && (fromStdin || !openCompressed())) {
+                close();
+                return false;
+            }
+            remaining_ = header_.recordCount;
+        } else {
+            // без заголовка: прочитанные байты – начало первых записей
+            std::memcpy(prefix_, &header_, prefix);
+            prefixSize_ = prefix;
+            uint64_t count = EMPLOYEE_COUNT_UNKNOWN;
+            if (!fromStdin) {
+                ifs_.clear();
+                ifs_.seekg(0, std::ios::end);
+                count = static_cast<uint64_t>(ifs_.tellg()) / sizeof(Employee);
+                ifs_.seekg(prefix, std::ios::beg);
+            }
+            header_ = makeLegacyEmployeeFileHeader(count);
+            remaining_ = EMPLOYEE_COUNT_UNKNOWN;
+        }
+        ok_ = true;
+        return true;
+    }
+
+    void close() {
+        if (ifs_.is_open()) ifs_.close();
+        ifs_.clear();
+        is_ = NULL;
+        pos_ = len_ = 0;
+        remaining_ = 0;
+        prefixSize_ = 0;
+        block_ = 0;
+        blocks_.clear();
+        checksum_ = EmployeeChecksum();
+        ok_ = false;
+    }
+
+    // заголовок файла; у файла без заголовка version == 0
+    const EmployeeFileHeader& header() const { return header_; }
+    // false – файл не открыт, обрезан или поврежден
+    bool ok() const { return ok_; }
+
+    // следующая запись или NULL в конце файла и при ошибке
+    const Employee* next() {
+        if (pos_ < len_) return &buffer_[pos_++];
+        if (!ok_ || !refill()) return NULL;
+        return &buffer_[pos_++];
+    }
+
+    const_iterator begin() { return const_iterator(this, next()); }
+    const_iterator end() { return const_iterator(); }
+
+private:
+    EmployeeFileReader(const EmployeeFileReader&);
+    EmployeeFileReader& operator=(const EmployeeFileReader&);
+
+    // каталог блоков сжатого файла из его конца
+    bool openCompressed() {
+        ifs_.seekg(0, std::ios::end);
+        uint64_t fileSize = static_cast<uint64_t>(ifs_.tellg());
+        if (fileSize < sizeof(header_) + 8) return false;
+        unsigned char trailer[8];
+        ifs_.seekg(static_cast<std::streamoff>(fileSize - 8), std::ios::beg);
+        if (!ifs_.read(reinterpret_cast<char*>(trailer), 8)) return false;
+        uint64_t directoryOffset = getLittleEndian(trailer, 8);
+        if (directoryOffset < sizeof(header_) || directoryOffset > fileSize - 8 ||
+            (fileSize - 8 - directoryOffset) % COMPRESSED_ENTRY_SIZE != 0) {
+            return false;
+        }
+        std::vector<unsigned char> directory(static_cast<size_t>(fileSize - 8 - directoryOffset));
+        ifs_.seekg(static_cast<std::streamoff>(directoryOffset), std::ios::beg);
+        if (!directory.empty() && !ifs_.read(reinterpret_cast<char*>(&directory[0]), directory.size())) return false;
+        uint64_t total = 0, expectedOffset = sizeof(header_);
+        blocks_.resize(directory.size() / COMPRESSED_ENTRY_SIZE);
+        for (size_t b = 0; b < blocks_.size(); b++) {
+            const unsigned char* p = &directory[b * COMPRESSED_ENTRY_SIZE];
+            CompressedBlockEntry& entry = blocks_[b];
+            entry.offset = getLittleEndian(p, 8);
+            entry.count = static_cast<uint32_t>(getLittleEndian(p + 8, 4));
+            entry.size = static_cast<uint32_t>(getLittleEndian(p + 12, 4));
+            // блоки идут подряд от заголовка до каталога и читаются без перемотки
+            if (entry.offset != expectedOffset || entry.size > directoryOffset - entry.offset) return false;
+            expectedOffset += entry.size;
+            total += entry.count;
+        }
+        if (expectedOffset != directoryOffset || total != header_.recordCount) return false;
+        ifs_.seekg(sizeof(header_), std::ios::beg);
+        return ifs_.good();
+    }
+
+    // дочитывание следующей порции записей; false – записи кончились или ошибка
+    bool refill() {
+        pos_ = len_ = 0;
+        if (header_.version == 0) {
+            // записи Employee до конца потока, неполная запись в конце отбрасывается
+            char* out = reinterpret_cast<char*>(&buffer_[0]);
+            std::memcpy(out, prefix_, prefixSize_);
+            size_t bytes = prefixSize_;
+            prefixSize_ = 0;
+            if (*is_) {
+                is_->read(out + bytes, buffer_.size() * sizeof(Employee) - bytes);
+                bytes += static_cast<size_t>(is_->gcount());
+            }
+            len_ = bytes / sizeof(Employee);
+            if (len_ == 0 && is_->bad()) ok_ = false;
+            return len_ > 0;
+        }
+        if (remaining_ > 0 && header_.format == EMPLOYEE_FORMAT_COMPRESSED) {
+            if (block_ >= blocks_.size()) return finish();
+            const CompressedBlockEntry& entry = blocks_[block_++];
+            blockBytes_.resize(entry.size);
+            if (entry.size > 0 && !is_->read(reinterpret_cast<char*>(&blockBytes_[0]), entry.size)) return fail();
+            if (entry.size > 0) checksum_.update(&blockBytes_[0], entry.size);
+            if (buffer_.size() < entry.count) buffer_.resize(entry.count);
+            if (!decodeEmployeeBlock(entry.size > 0 ? &blockBytes_[0] : NULL, entry.size, &buffer_[0], entry.count)) {
+                return fail();
+            }
+            len_ = entry.count;
+        } else if (remaining_ > 0) {
+            size_t wanted = static_cast<size_t>(std::min<uint64_t>(buffer_.size(), remaining_));
+            len_ = readEmployeeBlock(*is_, header_, &buffer_[0], wanted, checksum_);
+            if (len_ != wanted) return fail();
+        }
+        remaining_ -= len_;
+        return len_ > 0 || finish();
+    }
+
+    // все записи прочитаны – сверка контрольной суммы
+    bool finish() {
+        if (remaining_ != 0 || checksum_.value() != header_.checksum) ok_ = false;
+        return false;
+    }
+
+    bool fail() {
+        len_ = 0;
+        ok_ = false;
+        return false;
+    }
+
+    std::ifstream ifs_;
+    std::istream* is_;
+    EmployeeFileHeader header_;
+    std::vector<Employee> buffer_;
+    size_t pos_;
+    size_t len_;
+    uint64_t remaining_;
+    char prefix_[sizeof(EmployeeFileHeader)];
+    size_t prefixSize_;
+    std::vector<CompressedBlockEntry> blocks_;
+    std::vector<unsigned char> blockBytes_;
+    size_t block_;
+    EmployeeChecksum checksum_;
+    bool ok_;
+};
+
+#endif // EMPLOYEE_FILE_READER_H
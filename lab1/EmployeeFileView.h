@@ -0,0 +1,340 @@
+#ifndef EMPLOYEE_FILE_VIEW_H
+#define EMPLOYEE_FILE_VIEW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "Employee.h"
+#include "EmployeeCompression.h"
+
+#ifdef _WIN32
+// время изменения файла в единицах по 100 нс
+inline uint64_t handleModifiedTime(HANDLE file)
+{
+    FILETIME written;
+    if (!GetFileTime(file, NULL, NULL, &written)) return 0;
+    ULARGE_INTEGER value;
+    value.LowPart = written.dwLowDateTime;
+    value.HighPart = written.dwHighDateTime;
+    return value.QuadPart;
+}
+#else
+// время изменения файла в наносекундах
+inline uint64_t statModifiedTime(const struct stat& st)
+{
+    uint64_t seconds = static_cast<uint64_t>(st.st_mtime) * 1000000000ULL;
+#if defined(__APPLE__)
+    return seconds + static_cast<uint64_t>(st.st_mtimespec.tv_nsec);
+#elif defined(__linux__)
+    return seconds + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+#else
+    return seconds;
+#endif
+}
+#endif
+
+// Отображение файла в память: для чтения или, через openForUpdate, для
+// изменения на месте (изменения сразу видны другим процессам).
+class MappedFile {
+public:
+    MappedFile() : data_(NULL), size_(0), modified_(0), opened_(false), writable_(false) {
+#ifdef _WIN32
+        file_ = INVALID_HANDLE_VALUE;
+        mapping_ = NULL;
+#endif
+    }
+
+    explicit MappedFile(const char* filename) : data_(NULL), size_(0), modified_(0), opened_(false), writable_(false) {
+#ifdef _WIN32
+        file_ = INVALID_HANDLE_VALUE;
+        mapping_ = NULL;
+#endif
+        open(filename);
+    }
+
+    ~MappedFile() { close(); }
+
+    bool open(const char* filename) { return map(filename, false, 0); }
+
+    // существующий файл, при необходимости удлиненный нулями до minSize байт
+    bool openForUpdate(const char* filename, uint64_t minSize = 0) { return map(filename, true, minSize); }
+
+    void close() {
+#ifdef _WIN32
+        if (data_ != NULL) UnmapViewOfFile(data_);
+        if (mapping_ != NULL) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = NULL;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_ != NULL) munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = NULL;
+        size_ = 0;
+        modified_ = 0;
+        opened_ = false;
+        writable_ = false;
+    }
+
+    bool isOpen() const { return opened_; }
+    const char* data() const { return data_; }
+    // NULL, если файл открыт только для чтения
+    char* writableData() const { return writable_ ? const_cast<char*>(data_) : NULL; }
+    size_t size() const { return size_; }
+    // время изменения файла при открытии (нс, в Windows – по 100 нс)
+    uint64_t modified() const { return modified_; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    bool map(const char* filename, bool writable, uint64_t minSize) {
+        close();
+#ifdef _WIN32
+        // запись разрешена и другим: файл дописывают, пока его читают
+        file_ = CreateFileA(filename, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file_, &fileSize)) {
+            close();
+            return false;
+        }
+        if (writable && static_cast<uint64_t>(fileSize.QuadPart) < minSize) {
+            fileSize.QuadPart = static_cast<LONGLONG>(minSize);
+            if (!SetFilePointerEx(file_, fileSize, NULL, FILE_BEGIN) || !SetEndOfFile(file_)) {
+                close();
+                return false;
+            }
+        }
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+        modified_ = handleModifiedTime(file_);
+        opened_ = true;
+        writable_ = writable;
+        if (size_ == 0) return true;
+        mapping_ = CreateFileMappingA(file_, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+        if (mapping_ == NULL) {
+            close();
+            return false;
+        }
+        data_ = static_cast<const char*>(MapViewOfFile(mapping_, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+        if (data_ == NULL) {
+            close();
+            return false;
+        }
+#else
+        int fd = ::open(filename, writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        if (writable && static_cast<uint64_t>(st.st_size) < minSize) {
+            if (ftruncate(fd, static_cast<off_t>(minSize)) != 0 || fstat(fd, &st) != 0) {
+                ::close(fd);
+                return false;
+            }
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        modified_ = statModifiedTime(st);
+        opened_ = true;
+        writable_ = writable;
+        if (size_ == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* addr = writable ? mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                              : mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            size_ = 0;
+            opened_ = false;
+            writable_ = false;
+            return false;
+        }
+        // записи читаются последовательно
+        if (!writable) madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(addr);
+#endif
+        return true;
+    }
+
+    const char* data_;
+    size_t size_;
+    uint64_t modified_;
+    bool opened_;
+    bool writable_;
+#ifdef _WIN32
+    HANDLE file_;
+    HANDLE mapping_;
+#endif
+};
+
+// записей в блоке, который проверяется по сумме и сразу передается дальше, пока он в кэше
+const size_t VIEW_BLOCK_RECORDS = 2048;
+
+// Признаки состояния файла сотрудников, по которым индекс узнает, что файл
+// изменился после его построения. Файл с заголовком отличают число записей и
+// контрольная сумма; у файла без заголовка суммы нет, поэтому сравниваются
+// еще размер и время изменения.
+struct EmployeeFileStamp {
+    uint32_t version;      // версия заголовка, 0 – файл без заголовка
+    uint64_t recordCount;
+    uint64_t checksum;
+    uint64_t size;
+    uint64_t modified;
+};
+
+inline EmployeeFileStamp makeEmployeeFileStamp(const EmployeeFileHeader& header, uint64_t recordCount,
+                                               uint64_t size, uint64_t modified)
+{
+    EmployeeFileStamp stamp;
+    stamp.version = header.version;
+    stamp.recordCount = recordCount;
+    stamp.checksum = header.checksum;
+    stamp.size = size;
+    stamp.modified = modified;
+    return stamp;
+}
+
+inline bool sameEmployeeFileStamp(const EmployeeFileStamp& a, const EmployeeFileStamp& b)
+{
+    return a.version == b.version && a.recordCount == b.recordCount && a.checksum == b.checksum &&
+           (a.version != 0 || (a.size == b.size && a.modified == b.modified));
+}
+
+// представление бинарного файла сотрудников без копирования:
+// записи доступны напрямую из отображенной памяти
+class EmployeeFileView {
+public:
+    typedef const Employee* const_iterator;
+
+    EmployeeFileView() : header_(makeLegacyEmployeeFileHeader(0)), records_(NULL), count_(0) {}
+    explicit EmployeeFileView(const char* filename)
+        : header_(makeLegacyEmployeeFileHeader(0)), records_(NULL), count_(0) {
+        open(filename);
+    }
+
+    bool open(const char* filename) {
+        records_ = NULL;
+        count_ = 0;
+        if (!file_.open(filename)) return false;
+        size_t offset = 0;
+        if (hasEmployeeFileMagic(file_.data(), file_.size())) {
+            std::memcpy(&header_, file_.data(), sizeof(header_));
+            offset = sizeof(header_);
+            // неподдерживаемая версия, другая раскладка или обрезанный файл
+            // отображать напрямую можно только записи в раскладке Employee
+            if (!isSupportedEmployeeFileHeader(header_) || header_.format != EMPLOYEE_FORMAT_NATIVE ||
+                header_.recordCount > (file_.size() - offset) / sizeof(Employee)) {
+                close();
+                return false;
+            }
+        } else {
+            // неполная запись в конце файла без заголовка игнорируется, как в readEmployeeRecords
+            header_ = makeLegacyEmployeeFileHeader(file_.size() / sizeof(Employee));
+        }
+        count_ = static_cast<size_t>(header_.recordCount);
+        if (count_ > 0) records_ = reinterpret_cast<const Employee*>(file_.data() + offset);
+        return true;
+    }
+
+    void close() {
+        file_.close();
+        header_ = makeLegacyEmployeeFileHeader(0);
+        records_ = NULL;
+        count_ = 0;
+    }
+
+    bool isOpen() const { return file_.isOpen(); }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    const Employee* data() const { return records_; }
+    const_iterator begin() const { return records_; }
+    const_iterator end() const { return records_ + count_; }
+    const Employee& operator[](size_t i) const { return records_[i]; }
+
+    // заголовок файла; у файла без заголовка version == 0
+    const EmployeeFileHeader& header() const { return header_; }
+    bool sorted() const { return (header_.flags & EMPLOYEE_FLAG_SORTED) != 0; }
+    EmployeeFileStamp stamp() const { return makeEmployeeFileStamp(header_, count_, file_.size(), file_.modified()); }
+
+    // проверка контрольной суммы записей; файл без заголовка проверить нельзя
+    bool verifyChecksum() const {
+        return header_.version == 0 ||
+               employeeChecksum(records_, count_ * sizeof(Employee)) == header_.checksum;
+    }
+
+    // Проверка суммы с передачей записей блоками в sink.add(records, count):
+    // проверка и обработка записей идут за один проход по отображению.
+    // Если сумма не сошлась, sink уже получил записи и результат надо отбросить.
+    template <class Sink>
+    bool verifyChecksum(Sink& sink) const {
+        EmployeeChecksum checksum;
+        for (size_t first = 0; first < count_; first += VIEW_BLOCK_RECORDS) {
+            size_t n = std::min(VIEW_BLOCK_RECORDS, count_ - first);
+            if (header_.version != 0) checksum.update(records_ + first, n * sizeof(Employee));
+            sink.add(records_ + first, n);
+        }
+        return header_.version == 0 || checksum.value() == header_.checksum;
+    }
+
+private:
+    EmployeeFileView(const EmployeeFileView&);
+    EmployeeFileView& operator=(const EmployeeFileView&);
+
+    MappedFile file_;
+    EmployeeFileHeader header_;
+    const Employee* records_;
+    size_t count_;
+};
+
+// приемник блоков записей, дописывающий их в вектор
+struct EmployeeCopySink {
+    explicit EmployeeCopySink(std::vector<Employee>& employees) : employees(employees) {}
+
+    void add(const Employee* records, size_t count) { employees.insert(employees.end(), records, records + count); }
+
+    std::vector<Employee>& employees;
+};
+
+// загрузка записей через отображение: одно выделение памяти и копирование
+// вместе с проверкой суммы за один проход;
+// файл с неверной контрольной суммой отвергается, сжатый файл раскодируется параллельно,
+// файл другой раскладки читается readEmployeeRecords.
+// Как и readEmployeeRecords, на любом пути записи дописываются в конец employees,
+// а при ошибке вектор возвращается к прежнему размеру.
+inline bool loadEmployeeRecords(const char* filename, std::vector<Employee>& employees,
+                                EmployeeFileHeader* header = NULL)
+{
+    EmployeeFileView view;
+    if (std::strcmp(filename, "-") == 0) return readEmployeeRecords(filename, employees, header);
+    if (!view.open(filename)) {
+        return isCompressedEmployeeFile(filename) ? readEmployeeCompressed(filename, employees, header)
+                                                  : readEmployeeRecords(filename, employees, header);
+    }
+    size_t first = employees.size();
+    employees.reserve(first + view.size());
+    EmployeeCopySink sink(employees);
+    if (!view.verifyChecksum(sink)) {
+        employees.resize(first);
+        return false;
+    }
+    if (header != NULL) *header = view.header();
+    return true;
+}
+
+#endif // EMPLOYEE_FILE_VIEW_H
@@ -0,0 +1,105 @@
+#ifndef EMPLOYEE_FILE_WRITER_H
+#define EMPLOYEE_FILE_WRITER_H
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "Employee.h"
+
+// записей в одном блоке записи (~1.5 МиБ)
+const size_t EMPLOYEE_WRITER_CHUNK = 65536;
+
+// Потоковая запись бинарного файла крупными блоками: записи копятся в буфере,
+// контрольная сумма и флаг сортировки считаются по ходу, заголовок
+// дописывается в начало файла при close(). Раскладка записей задается в open().
+// Имя "-" – стандартный вывод: в канал заголовок не дописать, поэтому туда идут
+// записи Employee без заголовка, как в файлах старого формата.
+class EmployeeFileWriter {
+public:
+    EmployeeFileWriter() : out_(&ofs_), format_(EMPLOYEE_FORMAT_NATIVE), count_(0), sorted_(true), lastNum_(0) {
+        buffer_.reserve(EMPLOYEE_WRITER_CHUNK);
+    }
+
+    bool open(const char* filename, uint16_t format = EMPLOYEE_FORMAT_NATIVE) {
+        // колоночную раскладку потоком не записать: смещения колонок зависят от числа записей
+        if (!isRowEmployeeFormat(format)) return false;
+        format_ = format;
+        count_ = 0;
+        checksum_ = EmployeeChecksum();
+        sorted_ = true;
+        buffer_.clear();
+        if (std::strcmp(filename, "-") == 0) {
+            if (format != EMPLOYEE_FORMAT_NATIVE) return false;
+            setBinaryMode(stdout);
+            out_ = &std::cout;
+            return out_->good();
+        }
+        out_ = &ofs_;
+        ofs_.open(filename, std::ios::binary);
+        if (!ofs_) return false;
+        // место под заголовок
+        EmployeeFileHeader header = makeLegacyEmployeeFileHeader(0);
+        ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return ofs_.good();
+    }
+
+    bool write(const Employee& emp) {
+        if (count_ > 0 && emp.num < lastNum_) sorted_ = false;
+        lastNum_ = emp.num;
+        count_++;
+        buffer_.push_back(emp);
+        return buffer_.size() < EMPLOYEE_WRITER_CHUNK || flush();
+    }
+
+    // крупный блок записывается сразу, минуя буфер
+    bool write(const Employee* employees, size_t count) {
+        if (count == 0) return out_->good();
+        if (!flush()) return false;
+        if (count_ > 0 && employees[0].num < lastNum_) sorted_ = false;
+        if (sorted_ && !isSortedById(employees, count)) sorted_ = false;
+        lastNum_ = employees[count - 1].num;
+        count_ += count;
+        return writeEmployeeBlock(*out_, format_, employees, count, checksum_);
+    }
+
+    uint64_t count() const { return count_; }
+
+    // сброс накопленных записей; в канал они сразу уходят читающему процессу
+    bool flush() {
+        bool ok = buffer_.empty() || writeEmployeeBlock(*out_, format_, &buffer_[0], buffer_.size(), checksum_);
+        buffer_.clear();
+        if (out_ != &ofs_) out_->flush();
+        return ok && out_->good();
+    }
+
+    // сброс буфера, запись заголовка и закрытие файла
+    bool close() {
+        bool ok = flush();
+        if (out_ != &ofs_) return ok;
+        EmployeeFileHeader header = makeEmptyEmployeeFileHeader(format_);
+        header.flags = sorted_ ? EMPLOYEE_FLAG_SORTED : 0;
+        header.recordCount = count_;
+        header.checksum = checksum_.value();
+        ofs_.seekp(0, std::ios::beg);
+        ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ok = ofs_.good() && ok;
+        ofs_.close();
+        return ok && !ofs_.fail();
+    }
+
+private:
+    EmployeeFileWriter(const EmployeeFileWriter&);
+    EmployeeFileWriter& operator=(const EmployeeFileWriter&);
+
+    std::ofstream ofs_;
+    std::ostream* out_;
+    std::vector<Employee> buffer_;
+    uint16_t format_;
+    uint64_t count_;
+    EmployeeChecksum checksum_;
+    bool sorted_;
+    int lastNum_;
+};
+
+#endif // EMPLOYEE_FILE_WRITER_H
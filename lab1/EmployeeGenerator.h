@@ -0,0 +1,284 @@
+#ifndef EMPLOYEE_GENERATOR_H
+#define EMPLOYEE_GENERATOR_H
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include "Employee.h"
+#include "EmployeeFileWriter.h"
+#include "Parallel.h"
+
+// распределение id
+enum IdDistribution {
+    IDS_SEQUENTIAL,  // 1, 2, ..., N
+    IDS_SHUFFLED,    // перестановка 1..N
+    IDS_DESCENDING,  // N, N-1, ..., 1
+    IDS_DUPLICATES   // случайные id из 1..distinctIds с повторами
+};
+
+// распределение имен
+enum NameDistribution {
+    NAMES_POOL,    // равномерно из набора namePool имен
+    NAMES_ZIPF,    // из набора namePool имен с перекосом по закону Ципфа
+    NAMES_RANDOM   // случайные строки из 3–9 букв
+};
+
+// распределение часов
+enum HoursDistribution {
+    HOURS_UNIFORM,  // равномерно на [0, maxHours]
+    HOURS_NORMAL    // нормально со средним maxHours/2, обрезано по [0, maxHours]
+};
+
+struct GeneratorOptions {
+    uint64_t count;
+    IdDistribution ids;
+    uint64_t distinctIds;  // для IDS_DUPLICATES, 0 – count / 2
+    NameDistribution names;
+    uint32_t namePool;
+    HoursDistribution hours;
+    double maxHours;
+    uint64_t seed;
+    unsigned threads;      // 0 – по числу процессоров
+
+    GeneratorOptions()
+        : count(0), ids(IDS_SHUFFLED), distinctIds(0), names(NAMES_POOL), namePool(1000),
+          hours(HOURS_UNIFORM), maxHours(200), seed(1), threads(0) {}
+};
+
+inline bool parseIdDistribution(const char* name, IdDistribution& value)
+{
+    if (std::strcmp(name, "sequential") == 0) value = IDS_SEQUENTIAL;
+    else if (std::strcmp(name, "shuffled") == 0) value = IDS_SHUFFLED;
+    else if (std::strcmp(name, "descending") == 0) value = IDS_DESCENDING;
+    else if (std::strcmp(name, "duplicates") == 0) value = IDS_DUPLICATES;
+    else return false;
+    return true;
+}
+
+inline bool parseNameDistribution(const char* name, NameDistribution& value)
+{
+    if (std::strcmp(name, "pool") == 0) value = NAMES_POOL;
+    else if (std::strcmp(name, "zipf") == 0) value = NAMES_ZIPF;
+    else if (std::strcmp(name, "random") == 0) value = NAMES_RANDOM;
+    else return false;
+    return true;
+}
+
+inline bool parseHoursDistribution(const char* name, HoursDistribution& value)
+{
+    if (std::strcmp(name, "uniform") == 0) value = HOURS_UNIFORM;
+    else if (std::strcmp(name, "normal") == 0) value = HOURS_NORMAL;
+    else return false;
+    return true;
+}
+
+// splitmix64: быстрый генератор с хорошим перемешиванием,
+// результат зависит только от состояния – одинаков на всех платформах
+inline uint64_t splitmix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// равномерное число на [0, 1)
+inline double randomUnit(uint64_t& state)
+{
+    return (splitmix64(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Перестановка [0, count): сеть Фейстеля на 2*halfBits битах,
+// значения за пределами count пропускаются (cycle walking).
+class IdPermutation {
+public:
+    IdPermutation(uint64_t count, uint64_t seed) : count_(count), halfBits_(1) {
+        while ((static_cast<uint64_t>(1) << (2 * halfBits_)) < count) halfBits_++;
+        mask_ = (static_cast<uint64_t>(1) << halfBits_) - 1;
+        uint64_t state = seed;
+        for (int r = 0; r < ROUNDS; r++) keys_[r] = splitmix64(state);
+    }
+
+    uint64_t operator()(uint64_t index) const {
+        uint64_t x = index;
+        do {
+            x = encrypt(x);
+        } while (x >= count_);
+        return x;
+    }
+
+private:
+    enum { ROUNDS = 4 };
+
+    uint64_t encrypt(uint64_t x) const {
+        uint64_t left = x >> halfBits_;
+        uint64_t right = x & mask_;
+        for (int r = 0; r < ROUNDS; r++) {
+            uint64_t state = right ^ keys_[r];
+            uint64_t next = left ^ (splitmix64(state) & mask_);
+            left = right;
+            right = next;
+        }
+        return (left << halfBits_) | right;
+    }
+
+    uint64_t count_;
+    unsigned halfBits_;
+    uint64_t mask_;
+    uint64_t keys_[ROUNDS];
+};
+
+// Генератор записей: запись с номером i зависит только от seed и i,
+// поэтому результат не зависит от числа потоков.
+class EmployeeGenerator {
+public:
+    explicit EmployeeGenerator(const GeneratorOptions& options)
+        : options_(options), permutation_(options.count, options.seed ^ 0x5DEECE66DULL) {
+        if (options_.distinctIds == 0) options_.distinctIds = options_.count / 2 > 0 ? options_.count / 2 : 1;
+        if (options_.namePool == 0) options_.namePool = 1;
+        if (options_.names == NAMES_ZIPF) {
+            // накопленные веса 1/k для выбора имени двоичным поиском
+            zipfWeights_.resize(options_.namePool);
+            double total = 0;
+            for (uint32_t k = 0; k < options_.namePool; k++) {
+                total += 1.0 / (k + 1);
+                zipfWeights_[k] = total;
+            }
+            for (uint32_t k = 0; k < options_.namePool; k++) zipfWeights_[k] /= total;
+        }
+    }
+
+    const GeneratorOptions& options() const { return options_; }
+
+    void generate(uint64_t index, Employee& emp) const {
+        uint64_t state = options_.seed ^ (index * 0xD1B54A32D192ED03ULL);
+        std::memset(&emp, 0, sizeof(emp));
+        emp.num = makeId(index, state);
+        makeName(state, emp.name);
+        emp.hours = makeHours(state);
+    }
+
+    void generate(uint64_t first, Employee* out, size_t count) const {
+        for (size_t i = 0; i < count; i++) generate(first + i, out[i]);
+    }
+
+private:
+    int makeId(uint64_t index, uint64_t& state) const {
+        switch (options_.ids) {
+        case IDS_SEQUENTIAL:
+            return static_cast<int>(index + 1);
+        case IDS_DESCENDING:
+            return static_cast<int>(options_.count - index);
+        case IDS_DUPLICATES:
+            return static_cast<int>(1 + splitmix64(state) % options_.distinctIds);
+        default:
+            return static_cast<int>(permutation_(index) + 1);
+        }
+    }
+
+    void makeName(uint64_t& state, char* name) const {
+        static const char consonants[] = "bcdfghklmnprstvz";
+        static const char vowels[] = "aeiou";
+        uint64_t source;
+        size_t length;
+        if (options_.names == NAMES_RANDOM) {
+            source = splitmix64(state);
+            length = 3 + static_cast<size_t>(splitmix64(state) % 7);
+        } else {
+            uint32_t k;
+            if (options_.names == NAMES_ZIPF) {
+                double u = randomUnit(state);
+                k = static_cast<uint32_t>(std::lower_bound(zipfWeights_.begin(), zipfWeights_.end(), u) -
+                                          zipfWeights_.begin());
+                if (k >= options_.namePool) k = options_.namePool - 1;
+            } else {
+                k = static_cast<uint32_t>(splitmix64(state) % options_.namePool);
+            }
+            // имя из набора определяется только номером k
+            uint64_t nameState = k;
+            source = splitmix64(nameState);
+            length = 3 + static_cast<size_t>(source % 7);
+            source /= 7;
+        }
+        for (size_t i = 0; i < length; i++) {
+            if (i % 2 == 0) {
+                name[i] = consonants[source % 16];
+                source /= 16;
+            } else {
+                name[i] = vowels[source % 5];
+                source /= 5;
+            }
+        }
+        name[0] = static_cast<char>(name[0] - 'a' + 'A');
+    }
+
+    double makeHours(uint64_t& state) const {
+        double value;
+        if (options_.hours == HOURS_NORMAL) {
+            // преобразование Бокса–Мюллера
+            double u1 = 1.0 - randomUnit(state);
+            double u2 = randomUnit(state);
+            double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+            value = options_.maxHours / 2 + z * options_.maxHours / 6;
+            if (value < 0) value = 0;
+            if (value > options_.maxHours) value = options_.maxHours;
+        } else {
+            value = randomUnit(state) * options_.maxHours;
+        }
+        // часы с точностью до сотых, как в ручном вводе
+        return std::floor(value * 100 + 0.5) / 100;
+    }
+
+    GeneratorOptions options_;
+    IdPermutation permutation_;
+    std::vector<double> zipfWeights_;
+};
+
+// записей в блоке одного потока
+const size_t GENERATOR_BLOCK = 65536;
+
+struct GeneratorRound {
+    const EmployeeGenerator* generator;
+    std::vector<Employee>* blocks;
+    uint64_t first;  // номер первой записи раунда
+    uint64_t count;  // всего записей
+};
+
+inline void generateBlock(void* arg, size_t index)
+{
+    GeneratorRound* round = static_cast<GeneratorRound*>(arg);
+    uint64_t first = round->first + index * GENERATOR_BLOCK;
+    std::vector<Employee>& block = round->blocks[index];
+    block.clear();
+    if (first >= round->count) return;
+    uint64_t left = round->count - first;
+    block.resize(left < GENERATOR_BLOCK ? static_cast<size_t>(left) : GENERATOR_BLOCK);
+    round->generator->generate(first, &block[0], block.size());
+}
+
+// Генерация файла раундами: потоки параллельно заполняют по блоку,
+// затем блоки по порядку записываются в файл крупными кусками.
+inline bool generateEmployeeFile(const char* filename, const GeneratorOptions& options)
+{
+    EmployeeGenerator generator(options);
+    unsigned threads = options.threads > 0 ? options.threads : hardwareThreadCount();
+    std::vector<std::vector<Employee> > blocks(threads);
+
+    EmployeeFileWriter writer;
+    if (!writer.open(filename)) return false;
+    GeneratorRound round;
+    round.generator = &generator;
+    round.blocks = &blocks[0];
+    round.count = options.count;
+    bool ok = true;
+    for (round.first = 0; ok && round.first < options.count; round.first += threads * GENERATOR_BLOCK) {
+        runParallel(threads, generateBlock, &round);
+        for (unsigned t = 0; ok && t < threads; t++) {
+            if (!blocks[t].empty()) ok = writer.write(&blocks[t][0], blocks[t].size());
+        }
+    }
+    return writer.close() && ok;
+}
+
+#endif // EMPLOYEE_GENERATOR_H
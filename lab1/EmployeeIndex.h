@@ -0,0 +1,290 @@
+#ifndef EMPLOYEE_INDEX_H
+#define EMPLOYEE_INDEX_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include "Employee.h"
+#include "EmployeeFileView.h"
+
+// Индекс бинарного файла сотрудников (файл <имя>.idx):
+// заголовок EmployeeIndexHeader, затем entryCount записей EmployeeIndexEntry,
+// разбитых на runCount участков подряд. Каждый участок отсортирован по num,
+// для равных num – по смещению, и более чем вдвое длиннее следующего.
+// Построенный целиком индекс – один участок; дописывание добавляет участок
+// новых записей и сливает его на месте с короткими участками хвоста, так что
+// каждая запись переписывается O(log n) раз, а не при каждом дописывании.
+const char EMPLOYEE_INDEX_MAGIC[4] = { 'E', 'I', 'D', 'X' };
+const uint16_t EMPLOYEE_INDEX_VERSION = 3;
+// каждый участок вдвое больше следующего, поэтому 64 хватает на любой файл
+const size_t INDEX_MAX_RUNS = 64;
+
+struct EmployeeIndexHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t runCount;
+    uint32_t entrySize;       // sizeof(EmployeeIndexEntry)
+    uint32_t fileVersion;     // версия заголовка индексированного файла, 0 – файл без заголовка
+    uint64_t entryCount;
+    uint64_t fileRecordCount; // число записей в файле при построении индекса
+    uint64_t fileChecksum;    // контрольная сумма из заголовка файла
+    uint64_t fileSize;        // размер и время изменения файла: по ним узнается
+    uint64_t fileModified;    // перезапись файла без заголовка той же длины
+    uint64_t runs[INDEX_MAX_RUNS];  // число записей в участках по порядку
+};
+
+struct EmployeeIndexEntry {
+    int32_t num;
+    uint32_t reserved;
+    uint64_t offset;  // смещение записи от начала бинарного файла в байтах
+};
+
+struct EmployeeIndexEntryComparator {
+    bool operator()(const EmployeeIndexEntry& a, const EmployeeIndexEntry& b) const {
+        return a.num != b.num ? a.num < b.num : a.offset < b.offset;
+    }
+    bool operator()(const EmployeeIndexEntry& a, int num) const { return a.num < num; }
+    bool operator()(int num, const EmployeeIndexEntry& b) const { return num < b.num; }
+};
+
+inline std::string employeeIndexFilename(const char* binFilename)
+{
+    return std::string(binFilename) + ".idx";
+}
+
+// смещение первой записи в файле
+inline uint64_t employeeRecordsOffset(const EmployeeFileHeader& header)
+{
+    return header.version == 0 ? 0 : sizeof(EmployeeFileHeader);
+}
+
+inline void setEmployeeIndexStamp(EmployeeIndexHeader& header, const EmployeeFileStamp& stamp)
+{
+    header.fileVersion = stamp.version;
+    header.fileRecordCount = stamp.recordCount;
+    header.fileChecksum = stamp.checksum;
+    header.fileSize = stamp.size;
+    header.fileModified = stamp.modified;
+}
+
+// запись индекса из одного участка упорядоченных записей по состоянию файла stamp
+inline bool writeEmployeeIndex(const char* indexFilename, const EmployeeFileStamp& stamp,
+                               const std::vector<EmployeeIndexEntry>& entries)
+{
+    EmployeeIndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, EMPLOYEE_INDEX_MAGIC, sizeof(header.magic));
+    header.version = EMPLOYEE_INDEX_VERSION;
+    header.entrySize = sizeof(EmployeeIndexEntry);
+    header.entryCount = entries.size();
+    header.runCount = entries.empty() ? 0 : 1;
+    header.runs[0] = entries.size();
+    setEmployeeIndexStamp(header, stamp);
+
+    std::ofstream ofs(indexFilename, std::ios::binary);
+    if (!ofs) return false;
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!entries.empty()) {
+        ofs.write(reinterpret_cast<const char*>(&entries[0]), entries.size() * sizeof(EmployeeIndexEntry));
+    }
+    return ofs.good();
+}
+
+// упорядоченные записи индекса по отображенному файлу
+inline void makeEmployeeIndexEntries(const EmployeeFileView& view, std::vector<EmployeeIndexEntry>& entries)
+{
+    uint64_t base = employeeRecordsOffset(view.header());
+    entries.resize(view.size());
+    for (size_t i = 0; i < view.size(); i++) {
+        entries[i].num = view[i].num;
+        entries[i].reserved = 0;
+        entries[i].offset = base + static_cast<uint64_t>(i) * sizeof(Employee);
+    }
+    // отсортированный файл уже дает упорядоченный индекс
+    if (!view.sorted()) {
+        std::sort(entries.begin(), entries.end(), EmployeeIndexEntryComparator());
+    }
+}
+
+// построение индекса по отображенному файлу
+inline bool buildEmployeeIndex(const EmployeeFileView& view, const char* indexFilename)
+{
+    std::vector<EmployeeIndexEntry> entries;
+    makeEmployeeIndexEntries(view, entries);
+    return writeEmployeeIndex(indexFilename, view.stamp(), entries);
+}
+
+inline bool buildEmployeeIndex(const char* binFilename, const char* indexFilename)
+{
+    EmployeeFileView view;
+    return view.open(binFilename) && buildEmployeeIndex(view, indexFilename);
+}
+
+// отображенный в память индекс с двоичным поиском по num в каждом участке
+class EmployeeIndex {
+public:
+    typedef const EmployeeIndexEntry* const_iterator;
+
+    EmployeeIndex() : entries_(NULL), count_(0) {}
+
+    bool open(const char* indexFilename) {
+        close();
+        if (!file_.open(indexFilename)) return false;
+        if (file_.size() < sizeof(header_) ||
+            std::memcmp(file_.data(), EMPLOYEE_INDEX_MAGIC, sizeof(EMPLOYEE_INDEX_MAGIC)) != 0) {
+            file_.close();
+            return false;
+        }
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        uint64_t total = 0;
+        for (size_t r = 0; r < header_.runCount && r < INDEX_MAX_RUNS; r++) total += header_.runs[r];
+        if (header_.version != EMPLOYEE_INDEX_VERSION || header_.entrySize != sizeof(EmployeeIndexEntry) ||
+            header_.runCount > INDEX_MAX_RUNS || total != header_.entryCount ||
+            header_.entryCount > (file_.size() - sizeof(header_)) / sizeof(EmployeeIndexEntry)) {
+            file_.close();
+            return false;
+        }
+        count_ = static_cast<size_t>(header_.entryCount);
+        if (count_ > 0) entries_ = reinterpret_cast<const EmployeeIndexEntry*>(file_.data() + sizeof(header_));
+        runStarts_.assign(1, 0);
+        for (size_t r = 0; r < header_.runCount; r++) {
+            runStarts_.push_back(runStarts_.back() + static_cast<size_t>(header_.runs[r]));
+        }
+        return true;
+    }
+
+    void close() {
+        file_.close();
+        entries_ = NULL;
+        count_ = 0;
+        runStarts_.clear();
+    }
+
+    // построен ли индекс по текущему содержимому файла
+    bool matches(const EmployeeFileStamp& stamp) const {
+        return file_.isOpen() && sameEmployeeFileStamp(this->stamp(), stamp);
+    }
+
+    bool matches(const EmployeeFileView& view) const { return matches(view.stamp()); }
+
+    // состояние файла, по которому построен индекс
+    EmployeeFileStamp stamp() const {
+        EmployeeFileStamp stamp;
+        stamp.version = header_.fileVersion;
+        stamp.recordCount = header_.fileRecordCount;
+        stamp.checksum = header_.fileChecksum;
+        stamp.size = header_.fileSize;
+        stamp.modified = header_.fileModified;
+        return stamp;
+    }
+
+    const EmployeeIndexHeader& header() const { return header_; }
+    size_t size() const { return count_; }
+
+    size_t runCount() const { return runStarts_.empty() ? 0 : runStarts_.size() - 1; }
+
+    // упорядоченные записи участка
+    std::pair<const_iterator, const_iterator> run(size_t r) const {
+        return std::make_pair(entries_ + runStarts_[r], entries_ + runStarts_[r + 1]);
+    }
+
+    bool contains(int num) const {
+        for (size_t r = 0; r < runCount(); r++) {
+            if (std::binary_search(run(r).first, run(r).second, num, EmployeeIndexEntryComparator())) return true;
+        }
+        return false;
+    }
+
+    // записи с num из [from, to] по возрастанию num, для равных num – смещения
+    void range(int from, int to, std::vector<EmployeeIndexEntry>& found) const {
+        found.clear();
+        for (size_t r = 0; r < runCount(); r++) {
+            const_iterator first = std::lower_bound(run(r).first, run(r).second, from, EmployeeIndexEntryComparator());
+            const_iterator last = std::upper_bound(first, run(r).second, to, EmployeeIndexEntryComparator());
+            found.insert(found.end(), first, last);
+        }
+        if (runCount() > 1) std::sort(found.begin(), found.end(), EmployeeIndexEntryComparator());
+    }
+
+    void find(int num, std::vector<EmployeeIndexEntry>& found) const { range(num, num, found); }
+
+private:
+    EmployeeIndex(const EmployeeIndex&);
+    EmployeeIndex& operator=(const EmployeeIndex&);
+
+    MappedFile file_;
+    EmployeeIndexHeader header_;
+    const EmployeeIndexEntry* entries_;
+    size_t count_;
+    std::vector<size_t> runStarts_;  // начало каждого участка и конец последнего
+};
+
+// Добавление к индексу, построенному по состоянию файла before, записей added
+// (в любом порядке) с переходом к состоянию after. Записи дописываются участком
+// в конец файла индекса, и, пока предпоследний участок не длиннее последнего
+// более чем вдвое, два последних сливаются на месте. Заголовок пишется последним: прерванное
+// добавление оставляет индекс со старым состоянием, который файлу уже не
+// соответствует. false – индекса нет, он построен по другому состоянию файла
+// или не удалось его изменить.
+inline bool appendEmployeeIndexEntries(const char* indexFilename, const EmployeeFileStamp& before,
+                                       const EmployeeFileStamp& after, std::vector<EmployeeIndexEntry>& added)
+{
+    EmployeeIndexHeader header;
+    {
+        EmployeeIndex index;
+        if (!index.open(indexFilename) || !index.matches(before)) return false;
+        header = index.header();
+    }
+    if (!added.empty() && header.runCount == INDEX_MAX_RUNS) return false;
+    uint64_t count = header.entryCount + added.size();
+    MappedFile file;
+    if (!file.openForUpdate(indexFilename, sizeof(header) + count * sizeof(EmployeeIndexEntry)) ||
+        file.size() < sizeof(header)) {
+        return false;
+    }
+    EmployeeIndexEntry* entries = reinterpret_cast<EmployeeIndexEntry*>(file.writableData() + sizeof(header));
+    if (!added.empty()) {
+        std::sort(added.begin(), added.end(), EmployeeIndexEntryComparator());
+        std::memcpy(entries + header.entryCount, &added[0], added.size() * sizeof(EmployeeIndexEntry));
+        header.runs[header.runCount++] = added.size();
+    }
+    size_t end = static_cast<size_t>(count);
+    while (header.runCount >= 2 && header.runs[header.runCount - 2] <= 2 * header.runs[header.runCount - 1]) {
+        size_t middle = end - static_cast<size_t>(header.runs[header.runCount - 1]);
+        size_t first = middle - static_cast<size_t>(header.runs[header.runCount - 2]);
+        std::inplace_merge(entries + first, entries + middle, entries + end, EmployeeIndexEntryComparator());
+        header.runs[header.runCount - 2] += header.runs[header.runCount - 1];
+        header.runs[--header.runCount] = 0;
+    }
+    header.entryCount = count;
+    setEmployeeIndexStamp(header, after);
+    std::memcpy(file.writableData(), &header, sizeof(header));
+    return true;
+}
+
+// запись файла по смещению из индекса; NULL – смещение не указывает на запись файла
+inline const Employee* employeeAtOffset(const EmployeeFileView& view, uint64_t offset)
+{
+    uint64_t base = employeeRecordsOffset(view.header());
+    if (offset < base || (offset - base) % sizeof(Employee) != 0 ||
+        (offset - base) / sizeof(Employee) >= view.size()) {
+        return NULL;
+    }
+    return &view[static_cast<size_t>((offset - base) / sizeof(Employee))];
+}
+
+// Указывают ли найденные записи индекса на записи файла с num из [from, to].
+// Заголовок индекса не гарантирует этого для файла, измененного в обход
+// утилит, поэтому найденные записи перед выводом сверяются с файлом.
+inline bool employeeIndexRangeMatches(const EmployeeFileView& view, const std::vector<EmployeeIndexEntry>& found,
+                                      int from, int to)
+{
+    for (size_t i = 0; i < found.size(); i++) {
+        const Employee* emp = employeeAtOffset(view, found[i].offset);
+        if (emp == NULL || emp->num != found[i].num || emp->num < from || emp->num > to) return false;
+    }
+    return true;
+}
+
+#endif // EMPLOYEE_INDEX_H
@@ -0,0 +1,147 @@
+#ifndef EMPLOYEE_SORT_H
+#define EMPLOYEE_SORT_H
+
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "Employee.h"
+#include "Parallel.h"
+
+// алгоритм сортировки записей по id
+enum SortAlgorithm {
+    SORT_STD,       // std::sort в одном потоке
+    SORT_PARALLEL,  // параллельная сортировка слиянием
+    SORT_RADIX      // поразрядная LSD-сортировка по num
+};
+
+inline bool parseSortAlgorithm(const char* name, SortAlgorithm& algorithm)
+{
+    if (std::strcmp(name, "std") == 0) algorithm = SORT_STD;
+    else if (std::strcmp(name, "parallel") == 0) algorithm = SORT_PARALLEL;
+    else if (std::strcmp(name, "radix") == 0) algorithm = SORT_RADIX;
+    else return false;
+    return true;
+}
+
+// куски меньше этого размера сортируются в одном потоке
+const size_t PARALLEL_SORT_MIN_CHUNK = 1 << 14;
+
+struct ParallelSortState {
+    Employee* src;
+    Employee* dst;
+    std::vector<size_t> bounds;  // границы кусков: bounds[i]..bounds[i + 1]
+    size_t width;                // число сливаемых подряд кусков на текущем шаге
+};
+
+inline void parallelSortChunk(void* arg, size_t index)
+{
+    ParallelSortState* state = static_cast<ParallelSortState*>(arg);
+    std::sort(state->src + state->bounds[index], state->src + state->bounds[index + 1],
+              EmployeeComparator());
+}
+
+inline void parallelMergeChunks(void* arg, size_t index)
+{
+    ParallelSortState* state = static_cast<ParallelSortState*>(arg);
+    size_t chunks = state->bounds.size() - 1;
+    size_t first = index * 2 * state->width;
+    size_t middle = std::min(first + state->width, chunks);
+    size_t last = std::min(first + 2 * state->width, chunks);
+    Employee* src = state->src;
+    Employee* out = state->dst + state->bounds[first];
+    std::merge(src + state->bounds[first], src + state->bounds[middle],
+               src + state->bounds[middle], src + state->bounds[last],
+               out, EmployeeComparator());
+}
+
+// параллельная сортировка слиянием: куски сортируются в отдельных потоках,
+// затем попарно сливаются, на каждом шаге пары сливаются параллельно
+inline void parallelSortEmployees(std::vector<Employee>& employees, unsigned threads)
+{
+    size_t n = employees.size();
+    if (threads == 0) threads = hardwareThreadCount();
+    size_t chunks = std::min(static_cast<size_t>(threads), n / PARALLEL_SORT_MIN_CHUNK);
+    if (chunks <= 1) {
+        std::sort(employees.begin(), employees.end(), EmployeeComparator());
+        return;
+    }
+
+    std::vector<Employee> buffer(n);
+    ParallelSortState state;
+    state.src = &employees[0];
+    state.dst = &buffer[0];
+    state.bounds.resize(chunks + 1);
+    for (size_t i = 0; i <= chunks; i++) state.bounds[i] = n * i / chunks;
+    runParallel(chunks, parallelSortChunk, &state);
+
+    for (state.width = 1; state.width < chunks; state.width *= 2) {
+        size_t pairs = (chunks + 2 * state.width - 1) / (2 * state.width);
+        runParallel(pairs, parallelMergeChunks, &state);
+        std::swap(state.src, state.dst);
+    }
+    if (state.src != &employees[0]) employees.swap(buffer);
+}
+
+// ключ num со сдвигом знака, чтобы отрицательные id шли раньше положительных
+inline unsigned int radixKey(const Employee& e)
+{
+    return static_cast<unsigned int>(e.num) ^ 0x80000000u;
+}
+
+// поразрядная LSD-сортировка по 32-битному ключу num: три прохода по 11 бит;
+// проход пропускается, если все записи попали в одну корзину
+inline void radixSortEmployees(std::vector<Employee>& employees)
+{
+    const unsigned RADIX_BITS = 11;
+    const size_t BUCKETS = 1 << RADIX_BITS;
+    const unsigned PASSES = 3;
+    size_t n = employees.size();
+    if (n < 2) return;
+
+    std::vector<size_t> counts(PASSES * BUCKETS, 0);
+    for (size_t i = 0; i < n; i++) {
+        unsigned int key = radixKey(employees[i]);
+        for (unsigned pass = 0; pass < PASSES; pass++) {
+            counts[pass * BUCKETS + ((key >> (pass * RADIX_BITS)) & (BUCKETS - 1))]++;
+        }
+    }
+
+    std::vector<Employee> buffer(n);
+    Employee* src = &employees[0];
+    Employee* dst = &buffer[0];
+    for (unsigned pass = 0; pass < PASSES; pass++) {
+        size_t* count = &counts[pass * BUCKETS];
+        unsigned shift = pass * RADIX_BITS;
+        if (count[(radixKey(src[0]) >> shift) & (BUCKETS - 1)] == n) continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < BUCKETS; b++) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            dst[count[(radixKey(src[i]) >> shift) & (BUCKETS - 1)]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != &employees[0]) employees.swap(buffer);
+}
+
+// сортировка выбранным алгоритмом; threads == 0 – по числу процессоров
+inline void sortEmployees(std::vector<Employee>& employees, SortAlgorithm algorithm, unsigned threads)
+{
+    switch (algorithm) {
+    case SORT_PARALLEL:
+        parallelSortEmployees(employees, threads);
+        break;
+    case SORT_RADIX:
+        radixSortEmployees(employees);
+        break;
+    default:
+        sortEmployees(employees);
+        break;
+    }
+}
+
+#endif // EMPLOYEE_SORT_H
@@ -0,0 +1,240 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <queue>
+#include "Employee.h"
+#include "EmployeeSort.h"
+
+// не больше стольких отсортированных серий сливается за один проход
+const size_t EXTERNAL_SORT_MAX_FANIN = 128;
+// минимальный буфер чтения одной серии при слиянии
+const size_t EXTERNAL_SORT_MIN_RUN_BUFFER = 4096;
+
+// буферизованное чтение серии из временного файла
+class EmployeeRunReader {
+public:
+    EmployeeRunReader() : pos_(0), len_(0) {}
+
+    bool open(const std::string& filename, size_t bufferRecords) {
+        ifs_.open(filename.c_str(), std::ios::binary);
+        buffer_.resize(bufferRecords > 0 ? bufferRecords : 1);
+        pos_ = len_ = 0;
+        return ifs_.is_open() && refill();
+    }
+
+    bool empty() const { return pos_ >= len_; }
+    const Employee& front() const { return buffer_[pos_]; }
+
+    bool pop() {
+        pos_++;
+        return pos_ < len_ || refill();
+    }
+
+private:
+    bool refill() {
+        ifs_.read(reinterpret_cast<char*>(&buffer_[0]), buffer_.size() * sizeof(Employee));
+        pos_ = 0;
+        len_ = static_cast<size_t>(ifs_.gcount()) / sizeof(Employee);
+        return len_ > 0;
+    }
+
+    std::ifstream ifs_;
+    std::vector<Employee> buffer_;
+    size_t pos_;
+    size_t len_;
+};
+
+struct RunHeapItem {
+    int num;
+    size_t run;
+    // std::priority_queue держит наибольший элемент сверху, поэтому сравнение обратное;
+    // при равных id раньше идет запись из более ранней серии
+    bool operator<(const RunHeapItem& other) const {
+        return num != other.num ? num > other.num : run > other.run;
+    }
+};
+
+// k-путевое слияние серий через кучу; каждая запись передается в writer.write()
+template <class Writer>
+bool mergeEmployeeRuns(const std::vector<std::string>& runs, size_t memoryBudget, Writer& writer)
+{
+    size_t bufferRecords = memoryBudget / sizeof(Employee) / (runs.size() + 1);
+    if (bufferRecords < EXTERNAL_SORT_MIN_RUN_BUFFER) bufferRecords = EXTERNAL_SORT_MIN_RUN_BUFFER;
+
+    EmployeeRunReader* readers = new EmployeeRunReader[runs.size()];
+    std::priority_queue<RunHeapItem> heap;
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (readers[i].open(runs[i], bufferRecords)) {
+            RunHeapItem item = { readers[i].front().num, i };
+            heap.push(item);
+        }
+    }
+    bool ok = true;
+    while (ok && !heap.empty()) {
+        size_t run = heap.top().run;
+        heap.pop();
+        ok = writer.write(readers[run].front());
+        if (readers[run].pop()) {
+            RunHeapItem item = { readers[run].front().num, run };
+            heap.push(item);
+        }
+    }
+    delete[] readers;
+    return ok;
+}
+
+// k-путевое слияние отсортированных массивов записей в памяти через кучу;
+// при равных id раньше идет запись из массива с меньшим номером
+template <class Writer>
+bool mergeSortedEmployees(const std::vector<const Employee*>& ranges, const std::vector<size_t>& counts,
+                          Writer& writer)
+{
+    std::vector<size_t> positions(ranges.size(), 0);
+    std::priority_queue<RunHeapItem> heap;
+    for (size_t i = 0; i < ranges.size(); i++) {
+        if (counts[i] > 0) {
+            RunHeapItem item = { ranges[i][0].num, i };
+            heap.push(item);
+        }
+    }
+    bool ok = true;
+    while (ok && !heap.empty()) {
+        size_t run = heap.top().run;
+        heap.pop();
+        ok = writer.write(ranges[run][positions[run]]);
+        if (++positions[run] < counts[run]) {
+            RunHeapItem item = { ranges[run][positions[run]].num, run };
+            heap.push(item);
+        }
+    }
+    return ok;
+}
+
+// запись серии во временный файл
+class EmployeeRunWriter {
+public:
+    bool open(const std::string& filename) {
+        ofs_.open(filename.c_str(), std::ios::binary);
+        return ofs_.is_open();
+    }
+    bool write(const Employee& emp) {
+        ofs_.write(reinterpret_cast<const char*>(&emp), sizeof(Employee));
+        return ofs_.good();
+    }
+    bool close() {
+        ofs_.close();
+        return !ofs_.fail();
+    }
+
+private:
+    std::ofstream ofs_;
+};
+
+inline void removeEmployeeRuns(const std::vector<std::string>& runs)
+{
+    for (size_t i = 0; i < runs.size(); i++) std::remove(runs[i].c_str());
+}
+
+// Внешняя сортировка файла, не помещающегося в память:
+// файл читается сериями по memoryBudget байт, каждая серия сортируется и
+// сбрасывается во временный файл tempPrefix + ".runN", затем серии сливаются
+// k-путевым слиянием прямо в writer. Половина бюджета отводится под буфер сортировки.
+// Файл с флагом EMPLOYEE_FLAG_SORTED передается в writer без сортировки –
+// после отдельного проверочного прохода, чтобы обрезанный или испорченный файл
+// не попал в writer частично. Остальные файлы проверяются до слияния в writer.
+// Колоночный файл сериями не читается – для него возвращается false.
+template <class Writer>
+bool externalSortEmployees(const char* binFilename, size_t memoryBudget, const std::string& tempPrefix,
+                           SortAlgorithm algorithm, unsigned threads, Writer& writer)
+{
+    std::ifstream ifs(binFilename, std::ios::binary);
+    if (!ifs) return false;
+    EmployeeFileHeader header;
+    if (!readEmployeeFileHeader(ifs, header) || !isRowEmployeeFormat(header.format)) return false;
+    bool presorted = (header.flags & EMPLOYEE_FLAG_SORTED) != 0;
+    uint64_t remaining = header.recordCount;
+    EmployeeChecksum checksum;
+
+    size_t runRecords = memoryBudget / sizeof(Employee) / 2;
+    if (runRecords < EXTERNAL_SORT_MIN_RUN_BUFFER) runRecords = EXTERNAL_SORT_MIN_RUN_BUFFER;
+
+    std::vector<std::string> runs;
+    std::vector<Employee> run;
+    if (presorted) {
+        // число записей и контрольная сумма сверяются до первой записи в writer
+        std::streampos recordsStart = ifs.tellg();
+        EmployeeChecksum verified;
+        uint64_t left = remaining;
+        while (left > 0) {
+            size_t wanted = left < runRecords ? static_cast<size_t>(left) : runRecords;
+            run.resize(wanted);
+            size_t count = readEmployeeBlock(ifs, header, &run[0], wanted, verified);
+            if (count == 0) break;
+            left -= count;
+        }
+        if (left != 0 || verified.value() != header.checksum || ifs.bad()) return false;
+        ifs.clear();
+        ifs.seekg(recordsStart);
+        if (!ifs) return false;
+    }
+    bool ok = true;
+    while (ok && remaining > 0) {
+        size_t wanted = remaining < runRecords ? static_cast<size_t>(remaining) : runRecords;
+        run.resize(wanted);
+        run.resize(readEmployeeBlock(ifs, header, &run[0], wanted, checksum));
+        if (run.empty()) break;
+        if (remaining != EMPLOYEE_COUNT_UNKNOWN) remaining -= run.size();
+
+        if (presorted) {
+            for (size_t i = 0; ok && i < run.size(); i++) ok = writer.write(run[i]);
+            continue;
+        }
+        sortEmployees(run, algorithm, threads);
+
+        // весь файл поместился в одну серию – временные файлы не нужны
+        if (runs.empty() && (remaining == 0 || !ifs)) {
+            if (header.version != 0 && (remaining != 0 || checksum.value() != header.checksum)) return false;
+            for (size_t i = 0; ok && i < run.size(); i++) ok = writer.write(run[i]);
+            return ok;
+        }
+
+        std::ostringstream name;
+        name << tempPrefix << ".run" << runs.size();
+        runs.push_back(name.str());
+        EmployeeRunWriter runWriter;
+        ok = runWriter.open(runs.back());
+        for (size_t i = 0; ok && i < run.size(); i++) ok = runWriter.write(run[i]);
+        ok = runWriter.close() && ok;
+    }
+    std::vector<Employee>().swap(run);
+    // обрезанный файл или несовпадение контрольной суммы
+    if (header.version != 0 && (remaining != 0 || checksum.value() != header.checksum)) ok = false;
+
+    // слишком много серий для одного слияния – сливаем их группами в новые серии
+    size_t merged = 0;
+    while (ok && runs.size() - merged > EXTERNAL_SORT_MAX_FANIN) {
+        std::vector<std::string> group(runs.begin() + merged, runs.begin() + merged + EXTERNAL_SORT_MAX_FANIN);
+        merged += EXTERNAL_SORT_MAX_FANIN;
+        std::ostringstream name;
+        name << tempPrefix << ".run" << runs.size();
+        runs.push_back(name.str());
+        EmployeeRunWriter runWriter;
+        ok = runWriter.open(runs.back()) && mergeEmployeeRuns(group, memoryBudget, runWriter);
+        ok = runWriter.close() && ok;
+        removeEmployeeRuns(group);
+    }
+
+    if (ok && !runs.empty()) {
+        std::vector<std::string> rest(runs.begin() + merged, runs.end());
+        ok = mergeEmployeeRuns(rest, memoryBudget, writer);
+    }
+    removeEmployeeRuns(runs);
+    return ok && !ifs.bad();
+}
+
+#endif // EXTERNAL_SORT_H
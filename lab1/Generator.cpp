@@ -0,0 +1,77 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "Employee.h"
+#include "EmployeeGenerator.h"
+#include "EmployeeBloom.h"
+
+// Утилита Generator создает бинарный файл со случайными сотрудниками:
+// argv[1] – имя бинарного файла для записи,
+// argv[2] – количество записей (допускается запись вида 1e6).
+// Необязательные параметры:
+// --ids=sequential|shuffled|descending|duplicates – распределение id (по умолчанию shuffled),
+// --distinct=N – число различных id для duplicates (по умолчанию половина записей),
+// --names=pool|zipf|random – распределение имен (по умолчанию pool),
+// --name-pool=K – размер набора имен для pool и zipf (по умолчанию 1000),
+// --hours=uniform|normal – распределение часов (по умолчанию uniform),
+// --max-hours=H – наибольшее число часов (по умолчанию 200),
+// --seed=S – начальное значение генератора (по умолчанию 1),
+// --threads=N – число потоков (0 – по числу процессоров),
+// --bloom – рядом с файлом построить фильтр Блума по id <файл>.bloom (см. EmployeeBloom.h).
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: Generator <binary_file_name> <number_of_records>"
+                  << " [--ids=sequential|shuffled|descending|duplicates] [--distinct=N]"
+                  << " [--names=pool|zipf|random] [--name-pool=K] [--hours=uniform|normal]"
+                  << " [--max-hours=H] [--seed=S] [--threads=N] [--bloom]" << std::endl;
+        return 1;
+    }
+
+    const char* filename = argv[1];
+    GeneratorOptions options;
+    double count = std::atof(argv[2]);
+    if (count <= 0 || count > 2147483647.0) {
+        std::cerr << "Количество записей должно быть от 1 до 2147483647." << std::endl;
+        return 1;
+    }
+    options.count = static_cast<uint64_t>(count);
+    bool bloom = false;
+
+    for (int i = 3; i < argc; i++) {
+        const char* arg = argv[i];
+        bool ok = true;
+        if (std::strncmp(arg, "--ids=", 6) == 0) {
+            ok = parseIdDistribution(arg + 6, options.ids);
+        } else if (std::strncmp(arg, "--distinct=", 11) == 0) {
+            options.distinctIds = static_cast<uint64_t>(std::atof(arg + 11));
+        } else if (std::strncmp(arg, "--names=", 8) == 0) {
+            ok = parseNameDistribution(arg + 8, options.names);
+        } else if (std::strncmp(arg, "--name-pool=", 12) == 0) {
+            options.namePool = static_cast<uint32_t>(std::atol(arg + 12));
+        } else if (std::strncmp(arg, "--hours=", 8) == 0) {
+            ok = parseHoursDistribution(arg + 8, options.hours);
+        } else if (std::strncmp(arg, "--max-hours=", 12) == 0) {
+            options.maxHours = std::atof(arg + 12);
+        } else if (std::strncmp(arg, "--seed=", 7) == 0) {
+            options.seed = static_cast<uint64_t>(std::strtoul(arg + 7, NULL, 10));
+        } else if (std::strncmp(arg, "--threads=", 10) == 0) {
+            options.threads = static_cast<unsigned>(std::atoi(arg + 10));
+        } else if (std::strcmp(arg, "--bloom") == 0) {
+            bloom = true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Неизвестный параметр: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (!generateEmployeeFile(filename, options)) {
+        std::cerr << "Ошибка при записи в файл." << std::endl;
+        return 1;
+    }
+    if (bloom) buildEmployeeBloomSidecar(filename, std::cerr);
+    std::cout << "Файл успешно создан. Записей: " << options.count << "." << std::endl;
+    return 0;
+}
@@ -0,0 +1,79 @@
+#ifndef ID_HASH_SET_H
+#define ID_HASH_SET_H
+
+#include <cstddef>
+#include <climits>
+#include <vector>
+
+// значение свободной ячейки
+const int EMPLOYEE_ID_EMPTY = INT_MIN;
+
+// Множество id с открытой адресацией и линейным пробированием.
+// Сам id EMPLOYEE_ID_EMPTY учитывается отдельным флагом.
+class EmployeeIdSet {
+public:
+    explicit EmployeeIdSet(size_t expected = 16) : size_(0), hasEmptyId_(false) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) capacity *= 2;
+        slots_.assign(capacity, EMPLOYEE_ID_EMPTY);
+        mask_ = capacity - 1;
+    }
+
+    // true – id добавлен, false – такой id уже был
+    bool insert(int id) {
+        if (id == EMPLOYEE_ID_EMPTY) {
+            if (hasEmptyId_) return false;
+            hasEmptyId_ = true;
+            size_++;
+            return true;
+        }
+        if ((size_ + 1) * 2 > slots_.size()) grow();
+        size_t i = slot(id);
+        while (slots_[i] != EMPLOYEE_ID_EMPTY) {
+            if (slots_[i] == id) return false;
+            i = (i + 1) & mask_;
+        }
+        slots_[i] = id;
+        size_++;
+        return true;
+    }
+
+    bool contains(int id) const {
+        if (id == EMPLOYEE_ID_EMPTY) return hasEmptyId_;
+        size_t i = slot(id);
+        while (slots_[i] != EMPLOYEE_ID_EMPTY) {
+            if (slots_[i] == id) return true;
+            i = (i + 1) & mask_;
+        }
+        return false;
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    // мультипликативное хеширование: старшие биты произведения лучше перемешаны
+    size_t slot(int id) const {
+        unsigned int h = static_cast<unsigned int>(id) * 2654435769u;
+        return static_cast<size_t>(h ^ (h >> 16)) & mask_;
+    }
+
+    void grow() {
+        std::vector<int> old;
+        old.swap(slots_);
+        slots_.assign(old.size() * 2, EMPLOYEE_ID_EMPTY);
+        mask_ = slots_.size() - 1;
+        for (size_t j = 0; j < old.size(); j++) {
+            if (old[j] == EMPLOYEE_ID_EMPTY) continue;
+            size_t i = slot(old[j]);
+            while (slots_[i] != EMPLOYEE_ID_EMPTY) i = (i + 1) & mask_;
+            slots_[i] = old[j];
+        }
+    }
+
+    std::vector<int> slots_;
+    size_t mask_;
+    size_t size_;
+    bool hasEmptyId_;
+};
+
+#endif // ID_HASH_SET_H
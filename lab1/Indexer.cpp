@@ -0,0 +1,44 @@
+#include <iostream>
+#include <string>
+#include "Employee.h"
+#include "EmployeeAppend.h"
+#include "EmployeeIndex.h"
+#include "EmployeeBloom.h"
+
+// Утилита Indexer строит индекс по id для бинарного файла:
+// argv[1] – имя бинарного файла,
+// argv[2] – имя файла индекса (по умолчанию <бинарный файл>.idx).
+// Рядом с файлом строится и фильтр Блума <бинарный файл>.bloom.
+// Построение идет под исключительной блокировкой файла, как дописывание.
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: Indexer <binary_file_name> [index_file_name]" << std::endl;
+        return 1;
+    }
+
+    const char* binFilename = argv[1];
+    std::string indexFilename = argc == 3 ? argv[2] : employeeIndexFilename(binFilename);
+
+    int fd = openAsyncFile(binFilename, false);
+    if (fd < 0) {
+        std::cerr << "Ошибка чтения бинарного файла." << std::endl;
+        return 1;
+    }
+    EmployeeFileLock lock(fd);
+    EmployeeFileView view;
+    if (!lock.locked() || !view.open(binFilename)) {
+        std::cerr << "Ошибка чтения бинарного файла." << std::endl;
+        return 1;
+    }
+    if (!buildEmployeeIndex(view, indexFilename.c_str())) {
+        std::cerr << "Ошибка записи файла индекса." << std::endl;
+        return 1;
+    }
+    if (!buildEmployeeBloom(view, employeeBloomFilename(binFilename).c_str())) {
+        std::cerr << "Ошибка записи фильтра Блума." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Индекс " << indexFilename << " построен, записей: " << view.size() << "." << std::endl;
+    return 0;
+}
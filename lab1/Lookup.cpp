@@ -0,0 +1,98 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "Employee.h"
+#include "EmployeeAppend.h"
+#include "EmployeeIndex.h"
+#include "EmployeeBloom.h"
+
+// Поиск по индексу и фильтру под блокировкой файла. Если индекс нужно
+// перестроить, а rebuild не разрешен (блокировка разделяемая), возвращается -1.
+static int lookupEmployees(const char* binFilename, int from, int to, bool rebuild) {
+    EmployeeFileView view;
+    if (!view.open(binFilename)) {
+        std::cerr << "Ошибка чтения бинарного файла." << std::endl;
+        return 1;
+    }
+
+    EmployeeBloom bloom;
+    if (from == to && bloom.open(employeeBloomFilename(binFilename).c_str()) && bloom.matches(view) &&
+        !bloom.mayContain(from)) {
+        std::cout << "Сотрудники не найдены." << std::endl;
+        return 2;
+    }
+
+    std::string indexFilename = employeeIndexFilename(binFilename);
+    EmployeeIndex index;
+    if (!index.open(indexFilename.c_str()) || !index.matches(view)) {
+        if (!rebuild) return -1;
+        std::cerr << "Индекс отсутствует или устарел, строится заново." << std::endl;
+        index.close();
+        if (!buildEmployeeIndex(view, indexFilename.c_str()) || !index.open(indexFilename.c_str())) {
+            std::cerr << "Ошибка построения индекса." << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<EmployeeIndexEntry> found;
+    index.range(from, to, found);
+    if (!employeeIndexRangeMatches(view, found, from, to)) {
+        if (!rebuild) return -1;
+        std::cerr << "Индекс устарел: записи файла не совпадают с индексом, он строится заново." << std::endl;
+        index.close();
+        if (!buildEmployeeIndex(view, indexFilename.c_str()) || !index.open(indexFilename.c_str())) {
+            std::cerr << "Ошибка построения индекса." << std::endl;
+            return 1;
+        }
+        index.range(from, to, found);
+    }
+    if (found.empty()) {
+        std::cout << "Сотрудники не найдены." << std::endl;
+        return 2;
+    }
+    for (size_t i = 0; i < found.size(); i++) {
+        const Employee& emp = *employeeAtOffset(view, found[i].offset);
+        std::cout << "ID: " << emp.num
+                  << ", Имя: " << emp.name
+                  << ", Часы: " << emp.hours << std::endl;
+    }
+    return 0;
+}
+
+// Утилита Lookup ищет сотрудников по id двоичным поиском в индексе:
+// argv[1] – имя бинарного файла,
+// argv[2] – id сотрудника или начало диапазона,
+// argv[3] – конец диапазона (необязательно, включительно).
+// Индекс <бинарный файл>.idx перестраивается, если его нет или он устарел,
+// в том числе если найденные по нему записи не совпадают с искомыми id.
+// Отсутствие одного id проверяется по фильтру Блума <бинарный файл>.bloom без индекса.
+// Дописывающие процессы меняют индекс и фильтр на месте, поэтому поиск идет
+// под разделяемой блокировкой файла, а перестройка индекса – под исключительной.
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Usage: Lookup <binary_file_name> <id> [last_id]" << std::endl;
+        return 1;
+    }
+
+    const char* binFilename = argv[1];
+    int from = std::atoi(argv[2]);
+    int to = argc == 4 ? std::atoi(argv[3]) : from;
+
+    int fd = openAsyncFile(binFilename, false);
+    if (fd < 0) {
+        std::cerr << "Ошибка чтения бинарного файла." << std::endl;
+        return 1;
+    }
+    int result;
+    {
+        EmployeeFileLock lock(fd, false);
+        result = lock.locked() ? lookupEmployees(binFilename, from, to, false) : 1;
+    }
+    if (result < 0) {
+        EmployeeFileLock lock(fd);
+        result = lock.locked() ? lookupEmployees(binFilename, from, to, true) : 1;
+    }
+    closeAsyncFile(fd);
+    return result;
+}
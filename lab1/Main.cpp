@@ -3,20 +3,50 @@
 #include <sstream>
 #include <vector>
 #include <cstdlib>
+#include <cstring>
+#include <string>
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
 #endif
 #include "Employee.h"
+#include "EmployeeFileView.h"
+#include "EmployeeFileReader.h"
+#include "StageStats.h"
+
+void printEmployee(const Employee& emp) {
+    std::cout << "ID: " << emp.num
+              << ", Имя: " << emp.name
+              << ", Часы: " << emp.hours << std::endl;
+}
+
+void printEmployees(const Employee* employees, size_t count) {
+    std::cout << "Содержимое бинарного файла:" << std::endl;
+    for (size_t i = 0; i < count; i++) printEmployee(employees[i]);
+}
 
 void printBinaryFile(const char* filename) {
+    // записи в раскладке Employee выводятся прямо из отображения, остальные
+    // читаются потоком через буфер постоянного размера; колоночный файл загружается целиком
+    EmployeeFileView view;
+    EmployeeFileReader reader;
     std::vector<Employee> employees;
-    if (readEmployeeRecords(filename, employees)) {
+    if (view.open(filename)) {
+        printEmployees(view.data(), view.size());
+    } else if (reader.open(filename)) {
         std::cout << "Содержимое бинарного файла:" << std::endl;
-        for (size_t i = 0; i < employees.size(); i++) {
-            std::cout << "ID: " << employees[i].num 
-                      << ", Имя: " << employees[i].name 
-                      << ", Часы: " << employees[i].hours << std::endl;
-        }
+        for (EmployeeFileReader::const_iterator it = reader.begin(); it != reader.end(); ++it) printEmployee(*it);
+        if (!reader.ok()) std::cerr << "Ошибка чтения бинарного файла." << std::endl;
+    } else if (loadEmployeeRecords(filename, employees)) {
+        printEmployees(employees.empty() ? NULL : &employees[0], employees.size());
     } else {
         std::cerr << "Ошибка чтения бинарного файла." << std::endl;
     }
@@ -35,7 +65,98 @@ void printReport(const char* filename) {
     }
 }
 
-int runProcess(const std::string &command) {
+#ifndef _WIN32
+// Запуск утилиты без оболочки с готовым вектором аргументов; stdinFd и stdoutFd –
+// дескрипторы для стандартного ввода и вывода процесса, -1 – унаследовать от Main.
+bool spawnProcess(const std::vector<std::string>& args, int stdinFd, int stdoutFd, pid_t& pid) {
+    std::vector<char*> argv;
+    for (size_t i = 0; i < args.size(); i++) argv.push_back(const_cast<char*>(args[i].c_str()));
+    argv.push_back(NULL);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (stdinFd >= 0) posix_spawn_file_actions_adddup2(&actions, stdinFd, STDIN_FILENO);
+    if (stdoutFd >= 0) posix_spawn_file_actions_adddup2(&actions, stdoutFd, STDOUT_FILENO);
+    // Main игнорирует SIGPIPE, а дочерний процесс получает обычную обработку
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attributes, &signals);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF);
+
+    int error = posix_spawn(&pid, argv[0], &actions, &attributes, &argv[0], environ);
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0) {
+        std::cerr << "Не удалось запустить процесс " << args[0] << ": " << std::strerror(error) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Код завершения процесса; завершение по сигналу считается ошибкой.
+// Если задан stats, в него записываются время CPU и пиковая память процесса
+// из wait4, а байты ввода-вывода – из /proc/<pid>/io: завершившийся процесс
+// сначала только ожидается (WNOWAIT), пока его счетчики еще можно прочитать.
+int waitProcess(pid_t pid, StageStats* stats = NULL) {
+    int status;
+    struct rusage usage;
+    if (stats != NULL) {
+        siginfo_t info;
+        while (waitid(P_PID, static_cast<id_t>(pid), &info, WEXITED | WNOWAIT) < 0 && errno == EINTR) {}
+        char process[32];
+        std::sprintf(process, "%ld", static_cast<long>(pid));
+        readProcessIo(process, stats->readBytes, stats->writtenBytes);
+    }
+    while (wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR) return 1;
+    }
+    if (stats != NULL) applyRusage(usage, *stats);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+// канал, дескрипторы которого не наследуются запускаемыми процессами
+bool makePipe(int fds[2]) {
+    if (pipe(fds) != 0) return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+#endif
+
+std::string toolPath(const char* name) {
+#ifdef _WIN32
+    return std::string(name) + ".exe";
+#else
+    return std::string("./") + name;
+#endif
+}
+
+std::string joinArguments(const std::vector<std::string>& args) {
+    std::string command;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (i > 0) command += " ";
+        command += args[i].find(' ') == std::string::npos ? args[i] : "\"" + args[i] + "\"";
+    }
+    return command;
+}
+
+// запуск утилиты и ожидание ее завершения; stats – место для ее замеров или NULL
+int runProcess(const std::vector<std::string>& args, StageStats* stats = NULL) {
+    double started = nowSeconds();
 #ifdef _WIN32
     STARTUPINFO si;
     PROCESS_INFORMATION pi;
@@ -43,6 +164,7 @@ int runProcess(const std::string &command) {
     si.cb = sizeof(si);
     ZeroMemory(&pi, sizeof(pi));
 
+    std::string command = joinArguments(args);
     char* cmd = new char[command.size() + 1];
     std::strcpy(cmd, command.c_str());
 
@@ -52,62 +174,199 @@ int runProcess(const std::string &command) {
         return 1;
     }
     WaitForSingleObject(pi.hProcess, INFINITE);
+    if (stats != NULL) {
+        stats->wallSeconds = nowSeconds() - started;
+        applyProcessCounters(pi.hProcess, *stats);
+    }
+    DWORD exitCode = 0;
+    GetExitCodeProcess(pi.hProcess, &exitCode);
     CloseHandle(pi.hProcess);
     CloseHandle(pi.hThread);
     delete[] cmd;
-    return 0;
+    return static_cast<int>(exitCode);
 #else
-    int ret = system(command.c_str());
+    pid_t pid;
+    if (!spawnProcess(args, -1, -1, pid)) return 1;
+    int ret = waitProcess(pid, stats);
+    if (stats != NULL) stats->wallSeconds = nowSeconds() - started;
     if (ret != 0) {
-        std::cerr << "Ошибка при выполнении команды: " << command << std::endl;
+        std::cerr << "Ошибка при выполнении команды: " << joinArguments(args) << std::endl;
     }
     return ret;
 #endif
 }
 
-int main() {
-    char binFilename[256];
-    int numRecords;
+std::vector<std::string> makeArguments(const char* tool, const std::string& a, const std::string& b,
+                                       const std::string& c = std::string()) {
+    std::vector<std::string> args;
+    args.push_back(toolPath(tool));
+    args.push_back(a);
+    args.push_back(b);
+    if (!c.empty()) args.push_back(c);
+    return args;
+}
+
+// Обычный режим: Creator пишет бинарный файл, затем Reporter читает его.
+int runWithFiles(StageRecorder& recorder) {
+    std::string binFilename, numRecords;
 
     std::cout << "Введите имя бинарного файла: ";
     std::cin >> binFilename;
     std::cout << "Введите количество записей: ";
     std::cin >> numRecords;
 
-    std::ostringstream creatorCmd;
-#ifdef _WIN32
-    creatorCmd << "Creator.exe " << binFilename << " " << numRecords;
-#else
-    creatorCmd << "./Creator " << binFilename << " " << numRecords;
-#endif
-
-    if (runProcess(creatorCmd.str()) != 0) {
+    if (runProcess(makeArguments("Creator", binFilename, numRecords), recorder.child("Creator")) != 0) {
         std::cerr << "Процесс Creator завершился с ошибкой." << std::endl;
         return 1;
     }
 
-    printBinaryFile(binFilename);
+    recorder.begin("print_binary");
+    printBinaryFile(binFilename.c_str());
+    recorder.end();
 
-    char reportFilename[256];
-    double hourlyRate;
+    std::string reportFilename, hourlyRate;
     std::cout << "Введите имя файла отчета: ";
     std::cin >> reportFilename;
     std::cout << "Введите оплату за час работы: ";
     std::cin >> hourlyRate;
 
-    std::ostringstream reporterCmd;
+    std::vector<std::string> reporterArgs = makeArguments("Reporter", binFilename, reportFilename, hourlyRate);
+    if (runProcess(reporterArgs, recorder.child("Reporter")) != 0) {
+        std::cerr << "Процесс Reporter завершился с ошибкой." << std::endl;
+        return 1;
+    }
+
+    recorder.begin("print_report");
+    printReport(reportFilename.c_str());
+    recorder.end();
+
+    return 0;
+}
+
+// Режим конвейера: Creator пишет записи в канал сразу после ввода, Main выводит
+// их на экран и передает дальше по второму каналу в Reporter. Бинарный файл на
+// диске не создается, Reporter получает записи, пока Creator еще работает.
+int runPipeline(StageRecorder& recorder) {
 #ifdef _WIN32
-    reporterCmd << "Reporter.exe " << binFilename << " " << reportFilename << " " << hourlyRate;
+    std::cerr << "Режим --pipe поддерживается только в POSIX-системах." << std::endl;
+    return 1;
 #else
-    reporterCmd << "./Reporter " << binFilename << " " << reportFilename << " " << hourlyRate;
-#endif
+    std::string numRecords, reportFilename, hourlyRate;
+    std::cout << "Введите количество записей: ";
+    std::cin >> numRecords;
+    std::cout << "Введите имя файла отчета: ";
+    std::cin >> reportFilename;
+    std::cout << "Введите оплату за час работы: ";
+    std::cin >> hourlyRate;
 
-    if (runProcess(reporterCmd.str()) != 0) {
-        std::cerr << "Процесс Reporter завершился с ошибкой." << std::endl;
+    int creatorOut[2], reporterIn[2];
+    if (!makePipe(creatorOut)) {
+        std::cerr << "Не удалось создать канал." << std::endl;
         return 1;
     }
+    if (!makePipe(reporterIn)) {
+        std::cerr << "Не удалось создать канал." << std::endl;
+        close(creatorOut[0]);
+        close(creatorOut[1]);
+        return 1;
+    }
+    // если Reporter завершится раньше, запись в канал вернет ошибку вместо сигнала
+    signal(SIGPIPE, SIG_IGN);
+
+    StageStats* creatorStats = recorder.child("Creator");
+    StageStats* reporterStats = recorder.child("Reporter");
+    double started = nowSeconds();
+    pid_t creatorPid, reporterPid;
+    bool creatorStarted = spawnProcess(makeArguments("Creator", "-", numRecords), -1, creatorOut[1], creatorPid);
+    bool reporterStarted = spawnProcess(makeArguments("Reporter", "-", reportFilename, hourlyRate),
+                                        reporterIn[0], -1, reporterPid);
+    close(creatorOut[1]);
+    close(reporterIn[0]);
+    if (!reporterStarted) close(reporterIn[1]);
+
+    // записи приходят кусками произвольной длины; неполная запись ждет продолжения
+    std::vector<char> buffer(1 << 16);
+    size_t pending = 0;
+    bool forwarding = reporterStarted;
+    recorder.begin("forward");
+    std::cout << "Записи, переданные Reporter:" << std::endl;
+    while (creatorStarted) {
+        ssize_t got = read(creatorOut[0], &buffer[pending], buffer.size() - pending);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        if (forwarding && !writeAll(reporterIn[1], &buffer[pending], static_cast<size_t>(got))) {
+            std::cerr << "Reporter перестал принимать записи." << std::endl;
+            forwarding = false;
+        }
+        pending += static_cast<size_t>(got);
+        size_t whole = pending / sizeof(Employee);
+        for (size_t i = 0; i < whole; i++) {
+            Employee emp;
+            std::memcpy(&emp, &buffer[i * sizeof(Employee)], sizeof(emp));
+            printEmployee(emp);
+        }
+        pending -= whole * sizeof(Employee);
+        std::memmove(&buffer[0], &buffer[whole * sizeof(Employee)], pending);
+    }
+    close(creatorOut[0]);
+    if (reporterStarted) close(reporterIn[1]);
+    recorder.end();
 
-    printReport(reportFilename);
+    // процессы работают одновременно, время каждого – от общего запуска до его завершения
+    int creatorStatus = creatorStarted ? waitProcess(creatorPid, creatorStats) : 1;
+    if (creatorStats != NULL) creatorStats->wallSeconds = nowSeconds() - started;
+    int reporterStatus = reporterStarted ? waitProcess(reporterPid, reporterStats) : 1;
+    if (reporterStats != NULL) reporterStats->wallSeconds = nowSeconds() - started;
+    if (creatorStatus != 0) {
+        std::cerr << "Процесс Creator завершился с ошибкой." << std::endl;
+        return 1;
+    }
+    if (reporterStatus != 0) {
+        std::cerr << "Процесс Reporter завершился с ошибкой." << std::endl;
+        return 1;
+    }
 
+    recorder.begin("print_report");
+    printReport(reportFilename.c_str());
+    recorder.end();
     return 0;
-}
\ No newline at end of file
+#endif
+}
+
+// Без параметров Main запускает Creator и Reporter по очереди через бинарный файл,
+// с --pipe – одновременно, соединяя их каналом.
+// --stats – в конце таблица по стадиям: время, CPU, пиковая память и байты
+// ввода-вывода каждого процесса и работы самого Main; --stats=F – то же еще и в JSON-файл F.
+int main(int argc, char* argv[]) {
+    bool pipeline = false;
+    bool statsEnabled = false;
+    const char* statsFilename = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--pipe") == 0) {
+            pipeline = true;
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            statsEnabled = true;
+        } else if (std::strncmp(argv[i], "--stats=", 8) == 0) {
+            statsEnabled = true;
+            statsFilename = argv[i] + 8;
+        } else {
+            std::cerr << "Usage: Main [--pipe] [--stats[=json_file]]" << std::endl;
+            return 1;
+        }
+    }
+
+    StageRecorder recorder(statsEnabled);
+    int ret = pipeline ? runPipeline(recorder) : runWithFiles(recorder);
+    if (statsEnabled) {
+        std::cout << "\nЗамеры по стадиям:\n" << formatStageTable(recorder.stages());
+        if (statsFilename != NULL) {
+            std::ofstream ofs(statsFilename);
+            ofs << formatStageJson(recorder.stages());
+            if (!ofs) {
+                std::cerr << "Ошибка записи файла замеров." << std::endl;
+                return 1;
+            }
+        }
+    }
+    return ret;
+}
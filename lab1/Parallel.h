@@ -0,0 +1,93 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <vector>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// задача потока: arg – общие данные, index – номер потока
+typedef void (*ParallelTask)(void* arg, size_t index);
+
+// число доступных процессоров
+inline unsigned hardwareThreadCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? static_cast<unsigned>(info.dwNumberOfProcessors) : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? static_cast<unsigned>(n) : 1;
+#endif
+}
+
+struct ParallelTaskCall {
+    ParallelTask task;
+    void* arg;
+    size_t index;
+};
+
+#ifdef _WIN32
+inline DWORD WINAPI parallelThreadEntry(LPVOID param)
+{
+    ParallelTaskCall* call = static_cast<ParallelTaskCall*>(param);
+    call->task(call->arg, call->index);
+    return 0;
+}
+#else
+extern "C" inline void* parallelThreadEntry(void* param)
+{
+    ParallelTaskCall* call = static_cast<ParallelTaskCall*>(param);
+    call->task(call->arg, call->index);
+    return NULL;
+}
+#endif
+
+// запуск count копий задачи с индексами 0..count-1 и ожидание их завершения;
+// задача с индексом 0 выполняется в вызывающем потоке,
+// если поток создать не удалось – задача тоже выполняется на месте
+inline void runParallel(size_t count, ParallelTask task, void* arg)
+{
+    if (count == 0) return;
+    std::vector<ParallelTaskCall> calls(count);
+    for (size_t i = 0; i < count; i++) {
+        calls[i].task = task;
+        calls[i].arg = arg;
+        calls[i].index = i;
+    }
+#ifdef _WIN32
+    std::vector<HANDLE> threads(count, static_cast<HANDLE>(NULL));
+    for (size_t i = 1; i < count; i++) {
+        threads[i] = CreateThread(NULL, 0, parallelThreadEntry, &calls[i], 0, NULL);
+        if (threads[i] == NULL) task(arg, i);
+    }
+    task(arg, 0);
+    for (size_t i = 1; i < count; i++) {
+        if (threads[i] != NULL) {
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        }
+    }
+#else
+    std::vector<pthread_t> threads(count);
+    std::vector<bool> started(count, false);
+    for (size_t i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, parallelThreadEntry, &calls[i]) == 0;
+        if (!started[i]) task(arg, i);
+    }
+    task(arg, 0);
+    for (size_t i = 1; i < count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+#endif
+}
+
+#endif // PARALLEL_H
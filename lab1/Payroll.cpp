@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "Payroll.h"
+#include "EmployeeFileView.h"
+#include "IdHashSet.h"
+#include "ReportState.h"
+
+bool parseEmployeeLine(const std::string& line, Employee& emp) {
+    size_t delimiterPos = line.find_first_of(",;\t");
+    if (delimiterPos == std::string::npos) return false;
+    char delimiter = line[delimiterPos];
+    size_t secondPos = line.find(delimiter, delimiterPos + 1);
+    if (secondPos == std::string::npos) return false;
+
+    const char* text = line.c_str();
+    char* end;
+    long id = std::strtol(text, &end, 10);
+    while (*end == ' ') end++;
+    if (end == text || end != text + delimiterPos) return false;
+
+    size_t nameStart = delimiterPos + 1;
+    size_t nameEnd = secondPos;
+    while (nameStart < nameEnd && line[nameStart] == ' ') nameStart++;
+    while (nameEnd > nameStart && line[nameEnd - 1] == ' ') nameEnd--;
+    if (nameEnd == nameStart || nameEnd - nameStart >= sizeof(emp.name)) return false;
+
+    const char* hoursText = text + secondPos + 1;
+    double hours = std::strtod(hoursText, &end);
+    while (*end == ' ' || *end == '\r') end++;
+    if (end == hoursText || *end != '\0') return false;
+
+    std::memset(&emp, 0, sizeof(emp));
+    emp.num = static_cast<int>(id);
+    std::memcpy(emp.name, text + nameStart, nameEnd - nameStart);
+    emp.hours = hours;
+    return static_cast<long>(emp.num) == id;
+}
+
+// разбор таблицы в любой приемник записей с методом write(const Employee&)
+template <typename Writer>
+static bool importEmployeeLines(std::istream& source, Writer& writer, ImportStats& stats, std::ostream* errors) {
+    EmployeeIdSet ids;
+    std::string line;
+    size_t lineNumber = 0;
+    bool ok = true;
+    while (ok && std::getline(source, line)) {
+        lineNumber++;
+        if (line.empty() || line == "\r") continue;
+        Employee emp;
+        if (!parseEmployeeLine(line, emp)) {
+            if (lineNumber == 1) continue;
+            if (stats.errors++ < MAX_REPORTED_ERRORS && errors != NULL) {
+                *errors << "Ошибка в строке " << lineNumber << ": " << line << "\n";
+            }
+            continue;
+        }
+        if (!ids.insert(emp.num)) {
+            if (stats.duplicates++ < MAX_REPORTED_ERRORS && errors != NULL) {
+                *errors << "Строка " << lineNumber << ": сотрудник с ID " << emp.num << " уже существует.\n";
+            }
+            continue;
+        }
+        ok = writer.write(emp);
+        if (ok) stats.records++;
+    }
+    return ok;
+}
+
+bool createEmployees(std::istream& source, EmployeeFileWriter& writer, ImportStats& stats,
+                     std::ostream* errors) {
+    return importEmployeeLines(source, writer, stats, errors);
+}
+
+bool createEmployees(std::istream& source, EmployeeAppender& appender, ImportStats& stats,
+                     std::ostream* errors) {
+    AppendStats before = appender.stats();
+    ImportStats parsed;
+    bool ok = importEmployeeLines(source, appender, parsed, errors) && appender.flush();
+    // строки, прошедшие разбор, еще сверяются с id, которые уже есть в файле
+    const AppendStats& after = appender.stats();
+    stats.records += after.records - before.records;
+    stats.duplicates += parsed.duplicates + (after.duplicates - before.duplicates);
+    stats.errors += parsed.errors;
+    return ok;
+}
+
+bool generateReport(std::vector<Employee>& employees, bool sorted, const char* title,
+                    ReportWriter& writer, const ReportOptions& options) {
+    // отсортированный при записи файл не сортируется повторно
+    if (!sorted) sortEmployees(employees, options.sort, options.sortThreads);
+    writer.writeHeader(title);
+    return employees.empty() ||
+           writeReportParallel(writer, &employees[0], employees.size(), options.reportThreads);
+}
+
+// порядок номеров записей колоночного файла: по id, для равных id – по номеру
+struct ColumnIdLess {
+    const int* num;
+
+    bool operator()(size_t a, size_t b) const { return num[a] != num[b] ? num[a] < num[b] : a < b; }
+};
+
+bool generateReport(const EmployeeColumnView& columns, const char* title, ReportWriter& writer) {
+    writer.writeHeader(title);
+    size_t count = columns.size();
+    if (count == 0) return true;
+    const int* num = columns.num();
+    const double* hours = columns.hours();
+    bool ok = true;
+    if (columns.sorted()) {
+        // зарплаты считаются кусками, пока часы куска еще в кэше
+        std::vector<double> salaries(std::min(count, REPORT_CHUNK));
+        for (size_t first = 0; ok && first < count; first += REPORT_CHUNK) {
+            size_t n = std::min(REPORT_CHUNK, count - first);
+            computeSalaries(hours + first, n, writer.hourlyRate(), &salaries[0]);
+            for (size_t i = 0; ok && i < n; i++) {
+                ok = writer.write(num[first + i], columns.name(first + i), hours[first + i], salaries[i]);
+            }
+        }
+        return ok;
+    }
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) order[i] = i;
+    ColumnIdLess less;
+    less.num = num;
+    std::sort(order.begin(), order.end(), less);
+    std::vector<double> salaries(count);
+    computeSalaries(hours, count, writer.hourlyRate(), &salaries[0]);
+    for (size_t k = 0; ok && k < count; k++) {
+        size_t i = order[k];
+        ok = writer.write(num[i], columns.name(i), hours[i], salaries[i]);
+    }
+    return ok;
+}
+
+bool generateReport(const char* binFilename, const char* reportFilename, ReportWriter& writer,
+                    std::vector<Employee>& employees, const ReportOptions& options) {
+    employees.clear();
+    EmployeeColumnView columns;
+    if (std::strcmp(binFilename, "-") != 0 && columns.open(binFilename)) {
+        if (!columns.verifyChecksum() || !writer.open(reportFilename)) return false;
+        bool ok = generateReport(columns, binFilename, writer);
+        return writer.close() && ok;
+    }
+    EmployeeFileHeader header;
+    if (!loadEmployeeRecords(binFilename, employees, &header)) return false;
+    if (!writer.open(reportFilename)) return false;
+    bool ok = generateReport(employees, (header.flags & EMPLOYEE_FLAG_SORTED) != 0, binFilename, writer, options);
+    return writer.close() && ok;
+}
+
+bool generateReport(const char* binFilename, const char* reportFilename, double hourlyRate) {
+    ReportWriter writer(hourlyRate);
+    std::vector<Employee> employees;
+    return generateReport(binFilename, reportFilename, writer, employees);
+}
+
+bool generateReport(std::istream& bin, std::ostream& report, const char* title, double hourlyRate) {
+    std::vector<Employee> employees;
+    EmployeeFileHeader header;
+    if (!readEmployeeStream(bin, employees, &header)) return false;
+    ReportWriter writer(hourlyRate);
+    writer.open(report);
+    bool ok = generateReport(employees, (header.flags & EMPLOYEE_FLAG_SORTED) != 0, title, writer);
+    return writer.close() && ok;
+}
+
+// первые две строки отчета – заголовок
+static bool readReportHeader(std::istream& is, std::string& header) {
+    std::string title, columns;
+    if (!std::getline(is, title) || !std::getline(is, columns)) return false;
+    header = title + "\n" + columns + "\n";
+    return true;
+}
+
+static std::string expectedReportHeader(const char* binFilename) {
+    std::ostringstream header;
+    ReportWriter writer(1);
+    writer.open(header);
+    writer.writeHeader(binFilename);
+    writer.close();
+    return header.str();
+}
+
+// полное построение отчета с сохранением состояния
+static bool rebuildReportIncremental(const char* binFilename, const char* reportFilename, double hourlyRate,
+                                     const ReportOptions& options, IncrementalReportStats& stats) {
+    ReportWriter writer(hourlyRate);
+    std::vector<Employee> employees;
+    std::string stateFilename = reportStateFilename(reportFilename);
+    std::remove(stateFilename.c_str());
+    EmployeeFileHeader header;
+    if (!loadEmployeeRecords(binFilename, employees, &header) || !writer.open(reportFilename)) return false;
+    bool ok = generateReport(employees, (header.flags & EMPLOYEE_FLAG_SORTED) != 0, binFilename, writer, options);
+    if (!writer.close() || !ok) return false;
+    stats.rebuilt = true;
+    stats.newRecords = employees.size();
+    // состояние имеет смысл только для файла, который можно дописывать с продолжением суммы
+    if (header.version == 0 || header.format != EMPLOYEE_FORMAT_NATIVE) return true;
+    int lastNum = employees.empty() ? INT_MIN : employees.back().num;
+    return writeReportState(stateFilename.c_str(),
+                            makeReportState(header, lastNum, fileSize(reportFilename), hourlyRate));
+}
+
+bool generateReportIncremental(const char* binFilename, const char* reportFilename, double hourlyRate,
+                               const ReportOptions& options, IncrementalReportStats* stats) {
+    IncrementalReportStats localStats;
+    IncrementalReportStats& result = stats != NULL ? *stats : localStats;
+    result = IncrementalReportStats();
+
+    std::ifstream bin(binFilename, std::ios::binary);
+    EmployeeFileHeader header;
+    ReportState state;
+    std::string stateFilename = reportStateFilename(reportFilename);
+    if (!bin || !readEmployeeFileHeader(bin, header) || header.version == 0 ||
+        header.format != EMPLOYEE_FORMAT_NATIVE ||
+        !readReportState(stateFilename.c_str(), state) ||
+        state.recordSize != header.recordSize || state.hourlyRate != hourlyRate ||
+        state.recordCount > header.recordCount || state.reportSize != fileSize(reportFilename)) {
+        return rebuildReportIncremental(binFilename, reportFilename, hourlyRate, options, result);
+    }
+
+    // новые записи; их сумма, продолженная с суммы начала, должна дать сумму из заголовка
+    size_t count = static_cast<size_t>(header.recordCount - state.recordCount);
+    std::vector<Employee> added(count);
+    bin.seekg(static_cast<std::streamoff>(sizeof(EmployeeFileHeader) + state.recordCount * header.recordSize),
+              std::ios::beg);
+    EmployeeChecksum checksum(state.fileChecksum);
+    if ((count > 0 && readEmployeeBlock(bin, header, &added[0], count, checksum) != count) ||
+        checksum.value() != header.checksum) {
+        return rebuildReportIncremental(binFilename, reportFilename, hourlyRate, options, result);
+    }
+
+    std::ifstream old(reportFilename);
+    std::string oldHeader;
+    if (!old || !readReportHeader(old, oldHeader) || oldHeader != expectedReportHeader(binFilename)) {
+        old.close();
+        return rebuildReportIncremental(binFilename, reportFilename, hourlyRate, options, result);
+    }
+    result.newRecords = count;
+    if (count == 0) return true;
+    sortEmployees(added, options.sort, options.sortThreads);
+
+    ReportWriter writer(hourlyRate);
+    std::string tempFilename = std::string(reportFilename) + ".tmp";
+    if (added.front().num >= state.lastNum) {
+        // все новые id не меньше старых: строки дописываются в конец отчета
+        old.close();
+        std::ofstream append(reportFilename, std::ios::app);
+        if (!writer.open(append) || !writeReportParallel(writer, &added[0], count, options.reportThreads) ||
+            !writer.close()) {
+            return false;
+        }
+    } else {
+        // слияние: старая строка с тем же id остается перед новой
+        result.merged = true;
+        if (!writer.open(tempFilename.c_str())) return false;
+        writer.writeBlock(oldHeader.data(), oldHeader.size());
+        std::string line;
+        size_t next = 0;
+        while (std::getline(old, line)) {
+            int num = std::atoi(line.c_str());
+            while (next < count && added[next].num < num) writer.write(added[next++]);
+            line += '\n';
+            writer.writeBlock(line.data(), line.size());
+        }
+        if (next < count) writer.write(&added[next], count - next);
+        old.close();
+        if (!writer.close()) {
+            std::remove(tempFilename.c_str());
+            return false;
+        }
+        std::remove(reportFilename);
+        if (std::rename(tempFilename.c_str(), reportFilename) != 0) return false;
+    }
+
+    int lastNum = std::max(state.lastNum, added.back().num);
+    return writeReportState(stateFilename.c_str(),
+                            makeReportState(header, lastNum, fileSize(reportFilename), hourlyRate));
+}
@@ -0,0 +1,94 @@
+#ifndef PAYROLL_H
+#define PAYROLL_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Employee.h"
+#include "EmployeeAppend.h"
+#include "EmployeeColumns.h"
+#include "EmployeeFileWriter.h"
+#include "EmployeeSort.h"
+#include "Report.h"
+
+// Библиотека Payroll: логика Creator и Reporter без main(), чтобы обрабатывать
+// много файлов в одном процессе без запуска утилит.
+
+// сколько ошибочных строк выводить подробно при пакетной загрузке
+const size_t MAX_REPORTED_ERRORS = 10;
+
+// итоги загрузки записей из таблицы
+struct ImportStats {
+    uint64_t records;     // записано
+    uint64_t duplicates;  // пропущено строк с повторяющимся id
+    uint64_t errors;      // пропущено ошибочных строк
+
+    ImportStats() : records(0), duplicates(0), errors(0) {}
+};
+
+// разбор строки "id<разделитель>имя<разделитель>часы"; разделитель – ',', ';' или табуляция
+bool parseEmployeeLine(const std::string& line, Employee& emp);
+
+// Загрузка записей из CSV/TSV-потока в writer. Записи с повторяющимся id и ошибочные
+// строки пропускаются; первая строка, которую не удалось разобрать, считается
+// заголовком таблицы. Первые MAX_REPORTED_ERRORS проблем описываются в errors, если он задан.
+// false – ошибка записи.
+bool createEmployees(std::istream& source, EmployeeFileWriter& writer, ImportStats& stats,
+                     std::ostream* errors = NULL);
+
+// То же с дописыванием в существующий файл через appender: id, которые уже есть
+// в файле, тоже считаются дубликатами. Пачки дописываются под блокировкой файла,
+// поэтому несколько процессов могут загружать записи в один файл одновременно.
+bool createEmployees(std::istream& source, EmployeeAppender& appender, ImportStats& stats,
+                     std::ostream* errors = NULL);
+
+// параметры построения отчета
+struct ReportOptions {
+    SortAlgorithm sort;
+    unsigned sortThreads;    // 0 – по числу процессоров
+    unsigned reportThreads;  // 0 – по числу процессоров
+
+    ReportOptions() : sort(SORT_STD), sortThreads(0), reportThreads(1) {}
+};
+
+// Отчет по записям в памяти в открытый writer: заголовок с title и строки по
+// возрастанию id. Если sorted == false, employees сортируются на месте.
+bool generateReport(std::vector<Employee>& employees, bool sorted, const char* title,
+                    ReportWriter& writer, const ReportOptions& options = ReportOptions());
+
+// Отчет по отображенному колоночному файлу в открытый writer без перевода в
+// записи Employee: зарплаты считаются по колонке часов, строки идут по
+// возрастанию id, неотсортированный файл упорядочивается перестановкой номеров.
+bool generateReport(const EmployeeColumnView& columns, const char* title, ReportWriter& writer);
+
+// Отчет по бинарному файлу. writer и employees переиспользуются между вызовами,
+// поэтому при обработке множества файлов память выделяется один раз;
+// колоночный файл обрабатывается по колонкам.
+bool generateReport(const char* binFilename, const char* reportFilename, ReportWriter& writer,
+                    std::vector<Employee>& employees, const ReportOptions& options = ReportOptions());
+
+// отчет по бинарному файлу с выделением памяти на один вызов
+bool generateReport(const char* binFilename, const char* reportFilename, double hourlyRate);
+
+// отчет по записям из потока (любая построчная раскладка или записи без заголовка) в поток
+bool generateReport(std::istream& bin, std::ostream& report, const char* title, double hourlyRate);
+
+// итоги инкрементального построения отчета
+struct IncrementalReportStats {
+    bool rebuilt;         // отчет построен заново целиком
+    bool merged;          // новые строки вставлены между старыми (иначе дописаны в конец)
+    uint64_t newRecords;  // записей обработано в этом запуске
+
+    IncrementalReportStats() : rebuilt(false), merged(false), newRecords(0) {}
+};
+
+// Инкрементальный отчет по файлу, к которому только дописываются записи.
+// По состоянию <отчет>.state читаются лишь записи, добавленные после прошлого
+// запуска; они сортируются и сливаются с уже отсортированным отчетом. Если
+// состояния нет, начало файла изменилось, сменилась оплата или файл не в
+// раскладке Employee с заголовком, отчет строится заново.
+bool generateReportIncremental(const char* binFilename, const char* reportFilename, double hourlyRate,
+                               const ReportOptions& options = ReportOptions(),
+                               IncrementalReportStats* stats = NULL);
+
+#endif // PAYROLL_H
@@ -0,0 +1,269 @@
+#ifndef PAYROLL_GROUPS_H
+#define PAYROLL_GROUPS_H
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Employee.h"
+#include "Parallel.h"
+#include "Report.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PAYROLL_GROUPS_SSE2 1
+#endif
+
+// записей, начиная с которых группировка строится параллельно
+const size_t GROUP_PARALLEL_MIN = 1 << 16;
+
+// Ключ группы – имя до первого '\0', дополненное нулями до 16 байт, чтобы
+// сравнивать ключи одной векторной командой. Имя занимает не больше 10 байт,
+// поэтому последний байт свободен и отмечает занятую ячейку таблицы.
+struct NameKey {
+    unsigned char bytes[16];
+};
+
+inline void makeNameKey(const Employee& emp, NameKey& key)
+{
+    std::memset(&key, 0, sizeof(key));
+    const char* end = static_cast<const char*>(std::memchr(emp.name, '\0', sizeof(emp.name)));
+    std::memcpy(key.bytes, emp.name, end != NULL ? static_cast<size_t>(end - emp.name) : sizeof(emp.name));
+    key.bytes[15] = 1;
+}
+
+inline bool sameNameKey(const NameKey& a, const NameKey& b)
+{
+#ifdef PAYROLL_GROUPS_SSE2
+    __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.bytes)),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.bytes)));
+    return _mm_movemask_epi8(equal) == 0xFFFF;
+#else
+    return std::memcmp(a.bytes, b.bytes, sizeof(a.bytes)) == 0;
+#endif
+}
+
+// хеш ключа по двум 8-байтовым словам
+inline uint64_t hashNameKey(const NameKey& key)
+{
+    uint64_t low, high;
+    std::memcpy(&low, key.bytes, 8);
+    std::memcpy(&high, key.bytes + 8, 8);
+    uint64_t h = (low ^ (high * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 31);
+}
+
+// итоги одной группы
+struct NameGroup {
+    NameKey key;
+    uint64_t count;
+    double hours;
+};
+
+// порядок групп в отчете: по имени
+struct NameGroupLess {
+    bool operator()(const NameGroup& a, const NameGroup& b) const {
+        return std::memcmp(a.key.bytes, b.key.bytes, sizeof(a.key.bytes)) < 0;
+    }
+};
+
+// Таблица групп с открытой адресацией и линейным пробированием; ключи
+// хранятся в самих ячейках, поэтому на запись не выделяется память.
+class NameGroupTable {
+public:
+    explicit NameGroupTable(size_t expected = 16) : size_(0) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) capacity *= 2;
+        NameGroup empty;
+        std::memset(&empty, 0, sizeof(empty));
+        slots_.assign(capacity, empty);
+        mask_ = capacity - 1;
+    }
+
+    void add(const NameKey& key, uint64_t hash, uint64_t count, double hours) {
+        if ((size_ + 1) * 2 > slots_.size()) grow();
+        size_t i = static_cast<size_t>(hash) & mask_;
+        while (slots_[i].key.bytes[15] != 0) {
+            if (sameNameKey(slots_[i].key, key)) {
+                slots_[i].count += count;
+                slots_[i].hours += hours;
+                return;
+            }
+            i = (i + 1) & mask_;
+        }
+        slots_[i].key = key;
+        slots_[i].count = count;
+        slots_[i].hours = hours;
+        size_++;
+    }
+
+    void add(const NameGroup& group) { add(group.key, hashNameKey(group.key), group.count, group.hours); }
+
+    size_t size() const { return size_; }
+
+    // занятые ячейки в порядке таблицы
+    void collect(std::vector<NameGroup>& out) const {
+        for (size_t i = 0; i < slots_.size(); i++) {
+            if (slots_[i].key.bytes[15] != 0) out.push_back(slots_[i]);
+        }
+    }
+
+    void clear() {
+        NameGroup empty;
+        std::memset(&empty, 0, sizeof(empty));
+        std::fill(slots_.begin(), slots_.end(), empty);
+        size_ = 0;
+    }
+
+private:
+    void grow() {
+        std::vector<NameGroup> old;
+        old.swap(slots_);
+        NameGroup empty;
+        std::memset(&empty, 0, sizeof(empty));
+        slots_.assign(old.size() * 2, empty);
+        mask_ = slots_.size() - 1;
+        for (size_t j = 0; j < old.size(); j++) {
+            if (old[j].key.bytes[15] == 0) continue;
+            size_t i = static_cast<size_t>(hashNameKey(old[j].key)) & mask_;
+            while (slots_[i].key.bytes[15] != 0) i = (i + 1) & mask_;
+            slots_[i] = old[j];
+        }
+    }
+
+    std::vector<NameGroup> slots_;
+    size_t mask_;
+    size_t size_;
+};
+
+class NameGroupBuilder;
+
+struct NameGroupBuildState {
+    NameGroupBuilder* builder;
+    const Employee* employees;
+    size_t count;
+    size_t tasks;
+    std::vector<NameGroupTable>* locals;  // tasks x partitions таблиц потоков
+};
+
+inline void buildNameGroupsTask(void* arg, size_t index);
+inline void mergeNameGroupsTask(void* arg, size_t index);
+
+// Группировка записей по имени за один проход. Группы разбиты на разделы по
+// старшим битам хеша. Большой массив записей делится между потоками: каждый
+// раскладывает свой кусок по собственным таблицам разделов, затем каждый
+// раздел сливается своим потоком, так что потоки не делят ни одной таблицы.
+class NameGroupBuilder {
+public:
+    explicit NameGroupBuilder(unsigned threads = 1)
+        : threads_(threads > 0 ? threads : hardwareThreadCount()), partitions_(threads_) {}
+
+    void add(const Employee& emp) {
+        NameKey key;
+        makeNameKey(emp, key);
+        uint64_t hash = hashNameKey(key);
+        partitions_[partitionOf(hash)].add(key, hash, 1, emp.hours);
+    }
+
+    void add(const Employee* employees, size_t count) {
+        if (threads_ <= 1 || count < GROUP_PARALLEL_MIN) {
+            for (size_t i = 0; i < count; i++) add(employees[i]);
+            return;
+        }
+        std::vector<NameGroupTable> locals(static_cast<size_t>(threads_) * threads_);
+        NameGroupBuildState state;
+        state.builder = this;
+        state.employees = employees;
+        state.count = count;
+        state.tasks = threads_;
+        state.locals = &locals;
+        runParallel(threads_, buildNameGroupsTask, &state);
+        runParallel(threads_, mergeNameGroupsTask, &state);
+    }
+
+    // группы по возрастанию имени
+    void finish(std::vector<NameGroup>& out) {
+        out.clear();
+        size_t total = 0;
+        for (size_t p = 0; p < partitions_.size(); p++) total += partitions_[p].size();
+        out.reserve(total);
+        for (size_t p = 0; p < partitions_.size(); p++) {
+            partitions_[p].collect(out);
+            partitions_[p].clear();
+        }
+        std::sort(out.begin(), out.end(), NameGroupLess());
+    }
+
+    size_t partitionOf(uint64_t hash) const { return static_cast<size_t>((hash >> 40) % threads_); }
+    NameGroupTable& partition(size_t index) { return partitions_[index]; }
+
+private:
+    unsigned threads_;
+    std::vector<NameGroupTable> partitions_;
+};
+
+inline void buildNameGroupsTask(void* arg, size_t index)
+{
+    NameGroupBuildState& state = *static_cast<NameGroupBuildState*>(arg);
+    size_t first = state.count * index / state.tasks;
+    size_t last = state.count * (index + 1) / state.tasks;
+    NameGroupTable* tables = &(*state.locals)[index * state.tasks];
+    for (size_t i = first; i < last; i++) {
+        NameKey key;
+        makeNameKey(state.employees[i], key);
+        uint64_t hash = hashNameKey(key);
+        tables[state.builder->partitionOf(hash)].add(key, hash, 1, state.employees[i].hours);
+    }
+}
+
+inline void mergeNameGroupsTask(void* arg, size_t index)
+{
+    NameGroupBuildState& state = *static_cast<NameGroupBuildState*>(arg);
+    NameGroupTable& partition = state.builder->partition(index);
+    std::vector<NameGroup> groups;
+    for (size_t t = 0; t < state.tasks; t++) {
+        groups.clear();
+        (*state.locals)[t * state.tasks + index].collect(groups);
+        for (size_t g = 0; g < groups.size(); g++) partition.add(groups[g]);
+    }
+}
+
+// заголовок отчета по группам
+inline std::string formatGroupHeader(const std::vector<const char*>& binFilenames)
+{
+    std::string header = binFilenames.size() == 1 ? "Итоги по именам, файл" : "Итоги по именам, файлы";
+    for (size_t i = 0; i < binFilenames.size(); i++) {
+        header += std::string(i == 0 ? " \"" : ", \"") + binFilenames[i] + "\"";
+    }
+    return header + "\nИмя сотрудника\tСотрудников\tЧасы\tЗарплата\n";
+}
+
+// строка "имя\tчисло\tчасы\tзарплата\n"; out должен вмещать REPORT_MAX_LINE байт
+inline char* formatGroupLine(char* out, const NameGroup& group, double hourlyRate)
+{
+    const unsigned char* end = static_cast<const unsigned char*>(std::memchr(group.key.bytes, '\0', 15));
+    size_t nameLength = end != NULL ? static_cast<size_t>(end - group.key.bytes) : 15;
+    std::memcpy(out, group.key.bytes, nameLength);
+    out += nameLength;
+    *out++ = '\t';
+    out += std::sprintf(out, "%llu", static_cast<unsigned long long>(group.count));
+    *out++ = '\t';
+    out = formatReportMoney(out, group.hours);
+    *out++ = '\t';
+    out = formatReportMoney(out, group.hours * hourlyRate);
+    *out++ = '\n';
+    return out;
+}
+
+// запись групп в открытый отчет
+inline bool writeNameGroups(ReportWriter& writer, const std::vector<NameGroup>& groups)
+{
+    char line[REPORT_MAX_LINE];
+    bool ok = true;
+    for (size_t i = 0; ok && i < groups.size(); i++) {
+        char* end = formatGroupLine(line, groups[i], writer.hourlyRate());
+        ok = writer.writeBlock(line, static_cast<size_t>(end - line));
+    }
+    return ok;
+}
+
+#endif // PAYROLL_GROUPS_H
@@ -0,0 +1,92 @@
+#ifndef PAYROLL_QUERY_H
+#define PAYROLL_QUERY_H
+
+#include <algorithm>
+#include <vector>
+#include "Employee.h"
+
+// Выборка строк отчета: первые top по зарплате и/или записи не ниже порогов.
+// Пороги проверяются при потоковом просмотре записей, а для top хранится не
+// больше 2*top кандидатов, поэтому ни весь файл, ни полный отчет не сортируются.
+struct EmployeeQuery {
+    size_t top;           // 0 – без ограничения числа строк
+    bool hasMinHours;
+    double minHours;
+    bool hasMinSalary;
+    double minSalary;
+
+    EmployeeQuery() : top(0), hasMinHours(false), minHours(0), hasMinSalary(false), minSalary(0) {}
+
+    bool active() const { return top > 0 || hasMinHours || hasMinSalary; }
+};
+
+// порядок строк top: по убыванию зарплаты, при равной зарплате – по возрастанию id
+struct EarnsMore {
+    explicit EarnsMore(double hourlyRate) : hourlyRate(hourlyRate) {}
+    bool operator()(const Employee& a, const Employee& b) const {
+        double left = a.hours * hourlyRate, right = b.hours * hourlyRate;
+        return left != right ? left > right : a.num < b.num;
+    }
+    double hourlyRate;
+};
+
+class EmployeeSelector {
+public:
+    EmployeeSelector(const EmployeeQuery& query, double hourlyRate)
+        : query_(query), earnsMore_(hourlyRate), hasCutoff_(false), scanned_(0) {}
+
+    // Запись с NaN в часах не проходит ни порог, ни top: она не упорядочена
+    // относительно других и сломала бы nth_element.
+    bool matches(const Employee& emp) const {
+        double salary = emp.hours * earnsMore_.hourlyRate;
+        if (emp.hours != emp.hours || salary != salary) return false;
+        if (query_.hasMinHours && !(emp.hours >= query_.minHours)) return false;
+        if (query_.hasMinSalary && !(salary >= query_.minSalary)) return false;
+        return true;
+    }
+
+    void add(const Employee& emp) {
+        scanned_++;
+        if (!matches(emp)) return;
+        // после первого отбора запись, не лучше худшей из top, можно сразу отбросить
+        if (hasCutoff_ && !earnsMore_(emp, cutoff_)) return;
+        selected_.push_back(emp);
+        if (query_.top > 0 && selected_.size() >= 2 * query_.top) shrink();
+    }
+
+    void add(const Employee* employees, size_t count) {
+        for (size_t i = 0; i < count; i++) add(employees[i]);
+    }
+
+    // Выбранные записи: для top – по убыванию зарплаты, иначе в порядке добавления.
+    void finish(std::vector<Employee>& out) {
+        if (query_.top > 0) {
+            shrink();
+            std::sort(selected_.begin(), selected_.end(), earnsMore_);
+        }
+        out.swap(selected_);
+        selected_.clear();
+        hasCutoff_ = false;
+    }
+
+    uint64_t scanned() const { return scanned_; }
+
+private:
+    // оставить top лучших кандидатов за O(кандидатов) и запомнить худшего из них
+    void shrink() {
+        if (selected_.size() <= query_.top) return;
+        std::nth_element(selected_.begin(), selected_.begin() + (query_.top - 1), selected_.end(), earnsMore_);
+        selected_.resize(query_.top);
+        cutoff_ = selected_.back();
+        hasCutoff_ = true;
+    }
+
+    EmployeeQuery query_;
+    EarnsMore earnsMore_;
+    std::vector<Employee> selected_;
+    Employee cutoff_;
+    bool hasCutoff_;
+    uint64_t scanned_;
+};
+
+#endif // PAYROLL_QUERY_H
@@ -0,0 +1,300 @@
+#ifndef PAYROLL_SUMMARY_H
+#define PAYROLL_SUMMARY_H
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include "Employee.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PAYROLL_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PAYROLL_HAS_SSE2 1
+#endif
+
+// гистограмма часов: SUMMARY_BINS интервалов по SUMMARY_BIN_WIDTH часов,
+// отрицательные значения попадают в первый интервал, большие – в последний
+const size_t SUMMARY_BINS = 16;
+const double SUMMARY_BIN_WIDTH = 20;
+// часов в блоке, который собирается из записей в буфер на стеке
+const size_t SUMMARY_BLOCK = 512;
+
+// агрегаты по колонке часов
+struct HoursAggregate {
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+    uint64_t bins[SUMMARY_BINS];
+};
+
+inline void resetHoursAggregate(HoursAggregate& aggregate)
+{
+    std::memset(&aggregate, 0, sizeof(aggregate));
+    aggregate.min = std::numeric_limits<double>::infinity();
+    aggregate.max = -std::numeric_limits<double>::infinity();
+}
+
+// добавление count часов подряд к агрегату
+typedef void (*HoursKernel)(const double* hours, size_t count, HoursAggregate& aggregate);
+
+// номер интервала гистограммы; NaN попадает в первый интервал, как и в векторных ядрах
+inline size_t summaryBin(double hours)
+{
+    double bin = hours * (1 / SUMMARY_BIN_WIDTH);
+    if (!(bin >= 0)) bin = 0;
+    if (bin > SUMMARY_BINS - 1) bin = SUMMARY_BINS - 1;
+    return static_cast<size_t>(bin);
+}
+
+inline void accumulateHoursScalar(const double* hours, size_t count, HoursAggregate& aggregate)
+{
+    double s0 = 0, s1 = 0;
+    double low = aggregate.min, high = aggregate.max;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        s0 += hours[i];
+        s1 += hours[i + 1];
+    }
+    if (i < count) s0 += hours[i];
+    for (i = 0; i < count; i++) {
+        if (hours[i] < low) low = hours[i];
+        if (hours[i] > high) high = hours[i];
+        aggregate.bins[summaryBin(hours[i])]++;
+    }
+    aggregate.sum += s0 + s1;
+    aggregate.min = low;
+    aggregate.max = high;
+    aggregate.count += count;
+}
+
+#ifdef PAYROLL_HAS_SSE2
+// SSE2: по два значения за шаг; min/max берут накопленное значение при NaN
+inline void accumulateHoursSse2(const double* hours, size_t count, HoursAggregate& aggregate)
+{
+    __m128d sum = _mm_setzero_pd();
+    __m128d low = _mm_set1_pd(aggregate.min);
+    __m128d high = _mm_set1_pd(aggregate.max);
+    const __m128d scale = _mm_set1_pd(1 / SUMMARY_BIN_WIDTH);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d last = _mm_set1_pd(static_cast<double>(SUMMARY_BINS - 1));
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d x = _mm_loadu_pd(hours + i);
+        sum = _mm_add_pd(sum, x);
+        low = _mm_min_pd(x, low);
+        high = _mm_max_pd(x, high);
+        __m128d bin = _mm_min_pd(_mm_max_pd(_mm_mul_pd(x, scale), zero), last);
+        __m128i index = _mm_cvttpd_epi32(bin);
+        aggregate.bins[_mm_cvtsi128_si32(index)]++;
+        aggregate.bins[_mm_cvtsi128_si32(_mm_srli_si128(index, 4))]++;
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, sum);
+    aggregate.sum += lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, low);
+    aggregate.min = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    _mm_storeu_pd(lanes, high);
+    aggregate.max = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    aggregate.count += i;
+    if (i < count) accumulateHoursScalar(hours + i, count - i, aggregate);
+}
+#endif
+
+#ifdef PAYROLL_HAS_AVX2
+// AVX2: по четыре значения за шаг, два независимых сумматора
+__attribute__((target("avx2")))
+inline void accumulateHoursAvx2(const double* hours, size_t count, HoursAggregate& aggregate)
+{
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+    __m256d low = _mm256_set1_pd(aggregate.min);
+    __m256d high = _mm256_set1_pd(aggregate.max);
+    const __m256d scale = _mm256_set1_pd(1 / SUMMARY_BIN_WIDTH);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d last = _mm256_set1_pd(static_cast<double>(SUMMARY_BINS - 1));
+    int index[8];
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d x0 = _mm256_loadu_pd(hours + i);
+        __m256d x1 = _mm256_loadu_pd(hours + i + 4);
+        sum0 = _mm256_add_pd(sum0, x0);
+        sum1 = _mm256_add_pd(sum1, x1);
+        low = _mm256_min_pd(x0, _mm256_min_pd(x1, low));
+        high = _mm256_max_pd(x0, _mm256_max_pd(x1, high));
+        __m256d bin0 = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(x0, scale), zero), last);
+        __m256d bin1 = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(x1, scale), zero), last);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index), _mm256_cvttpd_epi32(bin0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index + 4), _mm256_cvttpd_epi32(bin1));
+        for (int k = 0; k < 8; k++) aggregate.bins[index[k]]++;
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+    aggregate.sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    _mm256_storeu_pd(lanes, low);
+    for (int k = 0; k < 4; k++) {
+        if (lanes[k] < aggregate.min) aggregate.min = lanes[k];
+    }
+    _mm256_storeu_pd(lanes, high);
+    for (int k = 0; k < 4; k++) {
+        if (lanes[k] > aggregate.max) aggregate.max = lanes[k];
+    }
+    aggregate.count += i;
+    if (i < count) accumulateHoursScalar(hours + i, count - i, aggregate);
+}
+#endif
+
+// лучшее ядро для текущего процессора, выбирается при первом вызове
+inline HoursKernel selectHoursKernel()
+{
+#ifdef PAYROLL_HAS_AVX2
+    if (__builtin_cpu_supports("avx2")) return accumulateHoursAvx2;
+#endif
+#ifdef PAYROLL_HAS_SSE2
+    return accumulateHoursSse2;
+#else
+    return accumulateHoursScalar;
+#endif
+}
+
+inline HoursKernel hoursKernel()
+{
+    static const HoursKernel kernel = selectHoursKernel();
+    return kernel;
+}
+
+// Сводка по фонду оплаты за один проход. Часы из записей собираются
+// блоками по SUMMARY_BLOCK в буфер на стеке и обрабатываются векторным ядром.
+class PayrollSummary {
+public:
+    explicit PayrollSummary(double hourlyRate, HoursKernel kernel = NULL)
+        : hourlyRate_(hourlyRate), kernel_(kernel != NULL ? kernel : hoursKernel()), used_(0) {
+        resetHoursAggregate(aggregate_);
+    }
+
+    void add(const Employee& emp) {
+        block_[used_++] = emp.hours;
+        if (used_ == SUMMARY_BLOCK) flush();
+    }
+
+    void add(const Employee* employees, size_t count) {
+        for (size_t i = 0; i < count; i++) add(employees[i]);
+    }
+
+    // часы, уже лежащие подряд (колоночный файл)
+    void addHours(const double* hours, size_t count) {
+        flush();
+        kernel_(hours, count, aggregate_);
+    }
+
+    const HoursAggregate& aggregate() {
+        flush();
+        return aggregate_;
+    }
+
+    double hourlyRate() const { return hourlyRate_; }
+    uint64_t count() { return aggregate().count; }
+    double totalHours() { return aggregate().sum; }
+    double totalPayroll() { return aggregate().sum * hourlyRate_; }
+    double minHours() { return count() > 0 ? aggregate_.min : 0; }
+    double maxHours() { return count() > 0 ? aggregate_.max : 0; }
+    double averageHours() { return count() > 0 ? aggregate_.sum / aggregate_.count : 0; }
+
+private:
+    void flush() {
+        if (used_ > 0) kernel_(block_, used_, aggregate_);
+        used_ = 0;
+    }
+
+    double hourlyRate_;
+    HoursKernel kernel_;
+    HoursAggregate aggregate_;
+    double block_[SUMMARY_BLOCK];
+    size_t used_;
+};
+
+// число с двумя знаками после точки
+inline std::string formatSummaryNumber(double value)
+{
+    char text[400];
+    std::sprintf(text, "%.2f", value);
+    return text;
+}
+
+// в JSON нет NaN и бесконечностей – они записываются как null
+inline std::string formatSummaryJsonNumber(double value)
+{
+    return value - value == 0 ? formatSummaryNumber(value) : std::string("null");
+}
+
+inline std::string formatSummaryCount(uint64_t value)
+{
+    char text[32];
+    std::sprintf(text, "%llu", static_cast<unsigned long long>(value));
+    return text;
+}
+
+// подпись интервала гистограммы: "[20.00, 40.00)", последний – "[300.00, ...)"
+inline std::string summaryBinLabel(size_t bin)
+{
+    std::string label = "[" + formatSummaryNumber(bin * SUMMARY_BIN_WIDTH) + ", ";
+    return label + (bin + 1 < SUMMARY_BINS ? formatSummaryNumber((bin + 1) * SUMMARY_BIN_WIDTH) + ")" : "...)");
+}
+
+// итоговый блок в конце текстового отчета
+inline std::string formatSummaryFooter(PayrollSummary& summary)
+{
+    const HoursAggregate& aggregate = summary.aggregate();
+    std::string text = "\nИтого сотрудников: " + formatSummaryCount(aggregate.count) + "\n";
+    text += "Всего часов: " + formatSummaryNumber(summary.totalHours()) + "\n";
+    text += "Фонд оплаты: " + formatSummaryNumber(summary.totalPayroll()) + "\n";
+    text += "Часы: мин " + formatSummaryNumber(summary.minHours()) +
+            ", макс " + formatSummaryNumber(summary.maxHours()) +
+            ", среднее " + formatSummaryNumber(summary.averageHours()) + "\n";
+    text += "Распределение часов:\n";
+    for (size_t bin = 0; bin < SUMMARY_BINS; bin++) {
+        text += summaryBinLabel(bin) + "\t" + formatSummaryCount(aggregate.bins[bin]) + "\n";
+    }
+    return text;
+}
+
+// та же сводка в JSON
+inline std::string formatSummaryJson(PayrollSummary& summary)
+{
+    const HoursAggregate& aggregate = summary.aggregate();
+    std::string text = "{\n";
+    text += "  \"count\": " + formatSummaryCount(aggregate.count) + ",\n";
+    text += "  \"hourly_rate\": " + formatSummaryJsonNumber(summary.hourlyRate()) + ",\n";
+    text += "  \"total_hours\": " + formatSummaryJsonNumber(summary.totalHours()) + ",\n";
+    text += "  \"total_payroll\": " + formatSummaryJsonNumber(summary.totalPayroll()) + ",\n";
+    text += "  \"min_hours\": " + formatSummaryJsonNumber(summary.minHours()) + ",\n";
+    text += "  \"max_hours\": " + formatSummaryJsonNumber(summary.maxHours()) + ",\n";
+    text += "  \"avg_hours\": " + formatSummaryJsonNumber(summary.averageHours()) + ",\n";
+    text += "  \"bin_width\": " + formatSummaryNumber(SUMMARY_BIN_WIDTH) + ",\n";
+    text += "  \"histogram\": [";
+    for (size_t bin = 0; bin < SUMMARY_BINS; bin++) {
+        text += (bin > 0 ? ", " : "") + formatSummaryCount(aggregate.bins[bin]);
+    }
+    return text + "]\n}\n";
+}
+
+// Передает записи в writer, попутно добавляя их в сводку;
+// нужен, когда записи идут потоком (внешняя сортировка).
+template <class Writer>
+class SummaryWriter {
+public:
+    SummaryWriter(Writer& writer, PayrollSummary& summary) : writer_(writer), summary_(summary) {}
+
+    bool write(const Employee& emp) {
+        summary_.add(emp);
+        return writer_.write(emp);
+    }
+
+private:
+    Writer& writer_;
+    PayrollSummary& summary_;
+};
+
+#endif // PAYROLL_SUMMARY_H
@@ -0,0 +1,252 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#include "Employee.h"
+#include "Parallel.h"
+
+// наибольшая длина строки отчета: число с двумя знаками после точки
+// в формате fixed может занимать больше 300 символов
+const size_t REPORT_MAX_LINE = 768;
+// размер буфера, который сбрасывается в файл одним вызовом
+const size_t REPORT_BUFFER_SIZE = 1 << 20;
+
+// целое в десятичной записи
+inline char* formatReportInt(char* out, int value)
+{
+    char digits[16];
+    unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+    int length = 0;
+    do {
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) *out++ = '-';
+    while (length > 0) *out++ = digits[--length];
+    return out;
+}
+
+// число с двумя знаками после точки, байт в байт как std::fixed << std::setprecision(2)
+inline char* formatReportMoney(char* out, double value)
+{
+#if __cplusplus >= 201703L
+    return std::to_chars(out, out + REPORT_MAX_LINE / 2, value, std::chars_format::fixed, 2).ptr;
+#else
+    // в C++98 нет snprintf; REPORT_MAX_LINE / 2 байт хватает на любое значение
+    int length = std::sprintf(out, "%.2f", value);
+    return out + (length > 0 ? length : 0);
+#endif
+}
+
+// строка отчета "id\tимя\tчасы\tзарплата\n" по значениям полей; name – до 10 байт,
+// как Employee::name; out должен вмещать REPORT_MAX_LINE байт
+inline char* formatReportLine(char* out, int num, const char* name, double hours, double salary)
+{
+    out = formatReportInt(out, num);
+    *out++ = '\t';
+    const char* end = static_cast<const char*>(std::memchr(name, '\0', sizeof(Employee().name)));
+    size_t nameLength = end != NULL ? static_cast<size_t>(end - name) : sizeof(Employee().name);
+    std::memcpy(out, name, nameLength);
+    out += nameLength;
+    *out++ = '\t';
+    out = formatReportMoney(out, hours);
+    *out++ = '\t';
+    out = formatReportMoney(out, salary);
+    *out++ = '\n';
+    return out;
+}
+
+inline char* formatReportLine(char* out, const Employee& emp, double hourlyRate)
+{
+    return formatReportLine(out, emp.num, emp.name, emp.hours, emp.hours * hourlyRate);
+}
+
+// Запись текстового отчета: заголовок и по строке на сотрудника.
+// Строки форматируются в буфер REPORT_BUFFER_SIZE байт, который сбрасывается
+// в файл целиком, без форматирования потоками и сброса после каждой строки.
+// Вместо файла отчет можно писать в уже открытый поток.
+class ReportWriter {
+public:
+    explicit ReportWriter(double hourlyRate)
+        : out_(&ofs_), hourlyRate_(hourlyRate), buffer_(REPORT_BUFFER_SIZE), used_(0) {}
+
+    bool open(const char* reportFilename) {
+        out_ = &ofs_;
+        ofs_.clear();  // в C++98 open() не сбрасывает ошибку прошлого файла
+        ofs_.open(reportFilename);
+        used_ = 0;
+        return ofs_.is_open();
+    }
+
+    // запись в поток os; close() его только сбрасывает
+    bool open(std::ostream& os) {
+        out_ = &os;
+        used_ = 0;
+        return os.good();
+    }
+
+    void writeHeader(const char* binFilename) {
+        std::string header = std::string("Отчет по файлу \"") + binFilename + "\"\n" +
+                             "Номер сотрудника\tИмя сотрудника\tЧасы\tЗарплата\n";
+        writeBlock(header.data(), header.size());
+    }
+
+    // заголовок отчета по нескольким файлам; для одного файла – как writeHeader(binFilename)
+    void writeHeader(const std::vector<const char*>& binFilenames) {
+        if (binFilenames.size() == 1) {
+            writeHeader(binFilenames[0]);
+            return;
+        }
+        std::string header = "Отчет по файлам";
+        for (size_t i = 0; i < binFilenames.size(); i++) {
+            header += std::string(i == 0 ? " \"" : ", \"") + binFilenames[i] + "\"";
+        }
+        header += "\nНомер сотрудника\tИмя сотрудника\tЧасы\tЗарплата\n";
+        writeBlock(header.data(), header.size());
+    }
+
+    bool write(const Employee& emp) {
+        if (buffer_.size() - used_ < REPORT_MAX_LINE && !flush()) return false;
+        used_ = formatReportLine(&buffer_[used_], emp, hourlyRate_) - &buffer_[0];
+        return true;
+    }
+
+    // строка по значениям колонок с уже посчитанной зарплатой
+    bool write(int num, const char* name, double hours, double salary) {
+        if (buffer_.size() - used_ < REPORT_MAX_LINE && !flush()) return false;
+        used_ = formatReportLine(&buffer_[used_], num, name, hours, salary) - &buffer_[0];
+        return true;
+    }
+
+    bool write(const Employee* employees, size_t count) {
+        bool ok = true;
+        for (size_t i = 0; ok && i < count; i++) ok = write(employees[i]);
+        return ok;
+    }
+
+    // запись готового текста
+    bool writeBlock(const char* data, size_t size) {
+        if (size == 0) return true;
+        if (buffer_.size() - used_ < size) {
+            if (!flush()) return false;
+            if (size >= buffer_.size()) {
+                out_->write(data, size);
+                return out_->good();
+            }
+        }
+        std::memcpy(&buffer_[used_], data, size);
+        used_ += size;
+        return true;
+    }
+
+    double hourlyRate() const { return hourlyRate_; }
+
+    bool flush() {
+        if (used_ > 0) out_->write(&buffer_[0], used_);
+        used_ = 0;
+        return out_->good();
+    }
+
+    bool close() {
+        bool ok = flush();
+        if (out_ != &ofs_) {
+            out_->flush();
+            return ok && out_->good();
+        }
+        ofs_.close();
+        return ok && !ofs_.fail();
+    }
+
+private:
+    ReportWriter(const ReportWriter&);
+    ReportWriter& operator=(const ReportWriter&);
+
+    std::ofstream ofs_;
+    std::ostream* out_;
+    double hourlyRate_;
+    std::vector<char> buffer_;
+    size_t used_;
+};
+
+// записей в куске, который форматирует один поток
+const size_t REPORT_CHUNK = 16384;
+
+// форматирование куска записей в отдельный буфер
+inline void formatReportChunk(const Employee* employees, size_t count, double hourlyRate, std::vector<char>& out)
+{
+    out.resize(count * 64 + REPORT_MAX_LINE);
+    size_t used = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (out.size() - used < REPORT_MAX_LINE) out.resize(out.size() * 2);
+        used = formatReportLine(&out[used], employees[i], hourlyRate) - &out[0];
+    }
+    out.resize(used);
+}
+
+struct ParallelReportState {
+    ReportWriter* writer;
+    const Employee* employees;
+    size_t count;
+    size_t formatters;                     // потоков-форматировщиков
+    size_t round;
+    std::vector<std::vector<char> > buffers[2];  // буферы четных и нечетных раундов
+    bool ok;
+};
+
+// Поток 0 записывает по порядку буферы предыдущего раунда,
+// остальные потоки тем временем форматируют свои куски текущего раунда.
+inline void parallelReportTask(void* arg, size_t index)
+{
+    ParallelReportState* state = static_cast<ParallelReportState*>(arg);
+    if (index == 0) {
+        if (state->round == 0) return;
+        std::vector<std::vector<char> >& previous = state->buffers[(state->round - 1) % 2];
+        for (size_t i = 0; state->ok && i < previous.size(); i++) {
+            if (!previous[i].empty()) state->ok = state->writer->writeBlock(&previous[i][0], previous[i].size());
+            previous[i].clear();
+        }
+        return;
+    }
+    std::vector<char>& out = state->buffers[state->round % 2][index - 1];
+    size_t first = (state->round * state->formatters + index - 1) * REPORT_CHUNK;
+    if (first >= state->count) {
+        out.clear();
+        return;
+    }
+    size_t count = std::min(REPORT_CHUNK, state->count - first);
+    formatReportChunk(state->employees + first, count, state->writer->hourlyRate(), out);
+}
+
+// Параллельная запись строк отчета: threads - 1 потоков форматируют куски
+// по REPORT_CHUNK записей в свои буферы, вызывающий поток одновременно пишет
+// в файл готовые буферы предыдущего раунда в исходном порядке.
+inline bool writeReportParallel(ReportWriter& writer, const Employee* employees, size_t count, unsigned threads)
+{
+    if (threads == 0) threads = hardwareThreadCount();
+    if (threads < 2 || count <= REPORT_CHUNK) return writer.write(employees, count);
+
+    ParallelReportState state;
+    state.writer = &writer;
+    state.employees = employees;
+    state.count = count;
+    state.formatters = threads - 1;
+    state.buffers[0].resize(state.formatters);
+    state.buffers[1].resize(state.formatters);
+    state.ok = true;
+    size_t rounds = (count + state.formatters * REPORT_CHUNK - 1) / (state.formatters * REPORT_CHUNK);
+    // последний раунд только дописывает буферы
+    for (state.round = 0; state.ok && state.round <= rounds; state.round++) {
+        runParallel(state.round < rounds ? threads : 1, parallelReportTask, &state);
+    }
+    return state.ok;
+}
+
+#endif // REPORT_H
@@ -0,0 +1,71 @@
+#ifndef REPORT_STATE_H
+#define REPORT_STATE_H
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include "Employee.h"
+
+// Состояние инкрементального отчета (файл <отчет>.state): сколько записей
+// бинарного файла уже вошло в отчет и контрольная сумма этого начала файла.
+// Дописанные записи проверяются продолжением суммы: employeeChecksum по
+// 24-байтовым записям продолжается с суммы начала без пересчета начала.
+const char REPORT_STATE_MAGIC[4] = { 'E', 'R', 'S', 'T' };
+const uint16_t REPORT_STATE_VERSION = 1;
+
+struct ReportState {
+    char magic[4];
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t recordSize;      // размер записи в бинарном файле
+    int32_t lastNum;          // наибольший id в отчете
+    uint64_t recordCount;     // записей бинарного файла в отчете
+    uint64_t fileChecksum;    // контрольная сумма этих записей
+    uint64_t reportSize;      // размер файла отчета в байтах после записи
+    double hourlyRate;
+};
+
+inline std::string reportStateFilename(const char* reportFilename)
+{
+    return std::string(reportFilename) + ".state";
+}
+
+inline ReportState makeReportState(const EmployeeFileHeader& header, int lastNum, uint64_t reportSize,
+                                   double hourlyRate)
+{
+    ReportState state;
+    std::memset(&state, 0, sizeof(state));
+    std::memcpy(state.magic, REPORT_STATE_MAGIC, sizeof(state.magic));
+    state.version = REPORT_STATE_VERSION;
+    state.recordSize = header.recordSize;
+    state.lastNum = lastNum;
+    state.recordCount = header.recordCount;
+    state.fileChecksum = header.checksum;
+    state.reportSize = reportSize;
+    state.hourlyRate = hourlyRate;
+    return state;
+}
+
+inline bool readReportState(const char* stateFilename, ReportState& state)
+{
+    std::ifstream ifs(stateFilename, std::ios::binary);
+    if (!ifs.read(reinterpret_cast<char*>(&state), sizeof(state))) return false;
+    return std::memcmp(state.magic, REPORT_STATE_MAGIC, sizeof(state.magic)) == 0 &&
+           state.version == REPORT_STATE_VERSION;
+}
+
+inline bool writeReportState(const char* stateFilename, const ReportState& state)
+{
+    std::ofstream ofs(stateFilename, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(&state), sizeof(state));
+    return ofs.good();
+}
+
+// размер файла в байтах, 0 – файла нет
+inline uint64_t fileSize(const char* filename)
+{
+    std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+    return ifs ? static_cast<uint64_t>(ifs.tellg()) : 0;
+}
+
+#endif // REPORT_STATE_H
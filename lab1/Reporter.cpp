@@ -2,17 +2,327 @@
 #include <fstream>
 #include <vector>
 #include <sstream>
+#include <cstdio>
 #include <cstdlib>
-#include <iomanip>
 #include "Employee.h"
+#include "EmployeeFileView.h"
+#include "EmployeeColumns.h"
+#include "EmployeeSort.h"
+#include "ExternalSort.h"
+#include "Report.h"
+#include "PayrollSummary.h"
+#include "PayrollQuery.h"
+#include "PayrollGroups.h"
+#include "EmployeeAsyncIO.h"
+#include "EmployeeFileReader.h"
+#include "Payroll.h"
+
+// Запись итогов (в конец отчета или в отдельный JSON-файл) и закрытие отчета;
+// возвращает код завершения программы.
+int finishReport(ReportWriter& report, PayrollSummary* summary, const char* summaryFilename) {
+    if (summary != NULL && summaryFilename == NULL) {
+        std::string footer = formatSummaryFooter(*summary);
+        report.writeBlock(footer.data(), footer.size());
+    }
+    if (!report.close()) {
+        std::cerr << "Ошибка записи файла отчета." << std::endl;
+        return 1;
+    }
+    if (summary != NULL && summaryFilename != NULL) {
+        std::ofstream ofs(summaryFilename);
+        ofs << formatSummaryJson(*summary);
+        if (!ofs) {
+            std::cerr << "Ошибка записи файла итогов." << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Блоки записей отображенного файла при проверке суммы: копируются в вектор
+// и, если нужны итоги, добавляются в сводку, пока блок еще в кэше.
+struct LoadedRecordsSink {
+    LoadedRecordsSink(std::vector<Employee>& employees, PayrollSummary* summary)
+        : copy(employees), summary(summary) {}
+
+    void add(const Employee* records, size_t count) {
+        copy.add(records, count);
+        if (summary != NULL) summary->add(records, count);
+    }
+
+    EmployeeCopySink copy;
+    PayrollSummary* summary;
+};
+
+// загрузка записей через отображение или, если задан asyncBackend, асинхронным чтением
+bool loadRecords(const char* binFilename, std::vector<Employee>& employees, EmployeeFileHeader& header,
+                 const AsyncBackend* asyncBackend) {
+    return asyncBackend != NULL ? readEmployeeRecordsAsync(binFilename, employees, &header, *asyncBackend)
+                                : loadEmployeeRecords(binFilename, employees, &header);
+}
+
+// Записи одного входного файла: отсортированный файл в раскладке Employee
+// читается прямо из отображения, остальные загружаются и сортируются.
+struct ReportSource {
+    EmployeeFileView view;
+    std::vector<Employee> records;
+    const Employee* data;
+    size_t count;
+    bool sorted;
+    bool ok;
+};
+
+struct ReportSourcesState {
+    const std::vector<const char*>* filenames;
+    ReportSource* sources;
+    size_t tasks;
+    SortAlgorithm algorithm;
+    unsigned sortThreads;
+    const AsyncBackend* asyncBackend;
+};
+
+inline void loadReportSource(ReportSourcesState& state, size_t i) {
+    const char* filename = (*state.filenames)[i];
+    ReportSource& source = state.sources[i];
+    source.ok = true;
+    if (std::strcmp(filename, "-") != 0 && state.asyncBackend == NULL && source.view.open(filename) &&
+        source.view.sorted()) {
+        source.ok = source.view.verifyChecksum();
+        source.data = source.view.data();
+        source.count = source.view.size();
+        source.sorted = source.view.sorted();
+        return;
+    }
+    source.view.close();
+    EmployeeFileHeader header;
+    source.ok = loadRecords(filename, source.records, header, state.asyncBackend);
+    source.sorted = (header.flags & EMPLOYEE_FLAG_SORTED) != 0;
+    if (source.ok && !source.sorted) {
+        sortEmployees(source.records, state.algorithm, state.sortThreads);
+        source.sorted = true;
+    }
+    source.data = source.records.empty() ? NULL : &source.records[0];
+    source.count = source.records.size();
+}
+
+// файлы распределяются между потоками через один
+inline void loadReportSourcesTask(void* arg, size_t index) {
+    ReportSourcesState* state = static_cast<ReportSourcesState*>(arg);
+    for (size_t i = index; i < state->filenames->size(); i += state->tasks) loadReportSource(*state, i);
+}
+
+// Загрузка всех входных файлов. Если файлов не меньше, чем потоков, каждый
+// файл загружается и сортируется в своем потоке; иначе файлы обрабатываются
+// по очереди, а потоки достаются сортировке одного файла.
+bool loadReportSources(const std::vector<const char*>& filenames, ReportSource* sources,
+                       const ReportOptions& options, const AsyncBackend* asyncBackend) {
+    unsigned threads = options.sortThreads > 0 ? options.sortThreads : hardwareThreadCount();
+    ReportSourcesState state;
+    state.filenames = &filenames;
+    state.sources = sources;
+    state.algorithm = options.sort;
+    state.asyncBackend = asyncBackend;
+    if (filenames.size() > 1 && filenames.size() >= threads) {
+        state.tasks = threads;
+        state.sortThreads = 1;
+        runParallel(state.tasks, loadReportSourcesTask, &state);
+    } else {
+        state.tasks = 1;
+        state.sortThreads = threads;
+        loadReportSourcesTask(&state, 0);
+    }
+    for (size_t i = 0; i < filenames.size(); i++) {
+        if (!sources[i].ok) {
+            std::cerr << "Ошибка чтения бинарного файла " << filenames[i] << "." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Отчет по нескольким файлам: каждый файл сортируется отдельно, а строки
+// отчета получаются k-путевым слиянием по id без объединения файлов.
+int runMerged(const std::vector<const char*>& binFilenames, const char* reportFilename,
+              ReportWriter& report, PayrollSummary* summary, const char* summaryFilename,
+              const ReportOptions& options, const AsyncBackend* asyncBackend) {
+    ReportSource* sources = new ReportSource[binFilenames.size()];
+    if (!loadReportSources(binFilenames, sources, options, asyncBackend)) {
+        delete[] sources;
+        return 1;
+    }
+    if (!report.open(reportFilename)) {
+        delete[] sources;
+        std::cerr << "Ошибка создания файла отчета." << std::endl;
+        return 1;
+    }
+    report.writeHeader(binFilenames);
+    std::vector<const Employee*> ranges(binFilenames.size());
+    std::vector<size_t> counts(binFilenames.size());
+    for (size_t i = 0; i < binFilenames.size(); i++) {
+        ranges[i] = sources[i].data;
+        counts[i] = sources[i].count;
+    }
+    if (summary != NULL) {
+        SummaryWriter<ReportWriter> summaryWriter(report, *summary);
+        mergeSortedEmployees(ranges, counts, summaryWriter);
+    } else {
+        mergeSortedEmployees(ranges, counts, report);
+    }
+    delete[] sources;
+    return finishReport(report, summary, summaryFilename);
+}
+
+// Отчет только по строкам выборки. Записи файлов, отображенных в память,
+// просматриваются один раз без копирования и сортировки всего файла; другие
+// раскладки и стандартный ввод читаются потоком через буфер постоянного размера,
+// а при асинхронном чтении записи файла сначала загружаются в память.
+int runQuery(const std::vector<const char*>& binFilenames, const char* reportFilename, const EmployeeQuery& query,
+             ReportWriter& report, PayrollSummary* summary, const char* summaryFilename,
+             const ReportOptions& options, const AsyncBackend* asyncBackend) {
+    EmployeeSelector selector(query, report.hourlyRate());
+    bool sorted = binFilenames.size() == 1;
+    for (size_t i = 0; i < binFilenames.size(); i++) {
+        const char* filename = binFilenames[i];
+        EmployeeFileView view;
+        EmployeeFileReader reader;
+        std::vector<Employee> employees;
+        EmployeeFileHeader header;
+        bool ok;
+        if (std::strcmp(filename, "-") != 0 && asyncBackend == NULL && view.open(filename)) {
+            // отбор идет в том же проходе, что и проверка суммы; при ошибке отчет не строится
+            ok = view.verifyChecksum(selector);
+            header = view.header();
+        } else if (asyncBackend == NULL && reader.open(filename)) {
+            for (const Employee* emp = reader.next(); emp != NULL; emp = reader.next()) selector.add(*emp);
+            ok = reader.ok();
+            header = reader.header();
+        } else {
+            ok = loadRecords(filename, employees, header, asyncBackend);
+            if (ok && !employees.empty()) selector.add(&employees[0], employees.size());
+        }
+        if (!ok) {
+            std::cerr << "Ошибка чтения бинарного файла " << filename << "." << std::endl;
+            return 1;
+        }
+        if ((header.flags & EMPLOYEE_FLAG_SORTED) == 0) sorted = false;
+    }
+
+    std::vector<Employee> selected;
+    selector.finish(selected);
+    // строки по порогу идут по возрастанию id, как в полном отчете, а top – по убыванию зарплаты
+    if (query.top == 0 && !sorted) sortEmployees(selected, options.sort, options.sortThreads);
+
+    if (!report.open(reportFilename)) {
+        std::cerr << "Ошибка создания файла отчета." << std::endl;
+        return 1;
+    }
+    report.writeHeader(binFilenames);
+    // итоги по выбранным строкам собираются при их записи
+    if (summary != NULL) {
+        SummaryWriter<ReportWriter> summaryWriter(report, *summary);
+        for (size_t i = 0; i < selected.size(); i++) summaryWriter.write(selected[i]);
+    } else if (!selected.empty()) {
+        report.write(&selected[0], selected.size());
+    }
+    return finishReport(report, summary, summaryFilename);
+}
+
+// Отчет по группам с одинаковым именем: число сотрудников, сумма часов и
+// зарплаты. Файлы читаются так же, как в runQuery, за один проход без
+// сортировки записей; отображенный файл группируется в несколько потоков.
+int runGrouped(const std::vector<const char*>& binFilenames, const char* reportFilename, ReportWriter& report,
+               PayrollSummary* summary, const char* summaryFilename, const ReportOptions& options,
+               const AsyncBackend* asyncBackend) {
+    NameGroupBuilder builder(options.sortThreads);
+    for (size_t i = 0; i < binFilenames.size(); i++) {
+        const char* filename = binFilenames[i];
+        EmployeeFileView view;
+        EmployeeFileReader reader;
+        std::vector<Employee> employees;
+        EmployeeFileHeader header;
+        bool ok;
+        if (std::strcmp(filename, "-") != 0 && asyncBackend == NULL && view.open(filename)) {
+            // итоги собираются в проходе проверки суммы, группировка – отдельно в несколько потоков
+            ok = summary != NULL ? view.verifyChecksum(*summary) : view.verifyChecksum();
+            if (ok) builder.add(view.data(), view.size());
+        } else if (asyncBackend == NULL && reader.open(filename)) {
+            for (const Employee* emp = reader.next(); emp != NULL; emp = reader.next()) {
+                builder.add(*emp);
+                if (summary != NULL) summary->add(*emp);
+            }
+            ok = reader.ok();
+        } else {
+            ok = loadRecords(filename, employees, header, asyncBackend);
+            if (ok && !employees.empty()) {
+                builder.add(&employees[0], employees.size());
+                if (summary != NULL) summary->add(&employees[0], employees.size());
+            }
+        }
+        if (!ok) {
+            std::cerr << "Ошибка чтения бинарного файла " << filename << "." << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<NameGroup> groups;
+    builder.finish(groups);
+    if (!report.open(reportFilename)) {
+        std::cerr << "Ошибка создания файла отчета." << std::endl;
+        return 1;
+    }
+    std::string header = formatGroupHeader(binFilenames);
+    report.writeBlock(header.data(), header.size());
+    writeNameGroups(report, groups);
+    return finishReport(report, summary, summaryFilename);
+}
+
+// Отчет по колоночному файлу: зарплаты и итоги считаются прямо по
+// отображенным колонкам, без перевода в записи Employee.
+int runColumnar(const EmployeeColumnView& columns, const char* binFilename, const char* reportFilename,
+                ReportWriter& report, PayrollSummary* summary, const char* summaryFilename) {
+    // итоги по колонке часов собираются в проходе проверки суммы
+    if (!(summary != NULL ? columns.verifyChecksum(*summary) : columns.verifyChecksum())) {
+        std::cerr << "Ошибка чтения бинарного файла." << std::endl;
+        return 1;
+    }
+    if (!report.open(reportFilename)) {
+        std::cerr << "Ошибка создания файла отчета." << std::endl;
+        return 1;
+    }
+    generateReport(columns, binFilename, report);
+    return finishReport(report, summary, summaryFilename);
+}
 
 // Утилита Reporter получает через командную строку:
-// argv[1] – имя исходного бинарного файла,
+// argv[1] – имя исходного бинарного файла ("-" – записи из стандартного ввода),
 // argv[2] – имя текстового файла отчета,
-// argv[3] – оплата за час работы.
+// argv[3] – оплата за час работы,
+// следующие имена без "--" – еще бинарные файлы (например, по одному на отдел):
+// отчет строится по всем файлам сразу слиянием по id, без их объединения.
+// Необязательные параметры:
+// --sort=std|parallel|radix – алгоритм сортировки (по умолчанию std),
+// --threads=N – число потоков для параллельной сортировки (0 – по числу процессоров),
+// --memory=M – внешняя сортировка с бюджетом памяти M МиБ для файлов больше памяти,
+// --report-threads=N – форматирование отчета в N потоков (0 – по числу процессоров),
+// --summary – итоги (фонд оплаты, мин/макс/среднее часов, гистограмма) в конце отчета,
+// --summary=F – те же итоги в JSON-файл F,
+// --incremental – в отчет добавляются только записи, дописанные в файл с прошлого
+//                 запуска (состояние хранится в <отчет>.state),
+// --top=K – только K сотрудников с наибольшей зарплатой, по убыванию зарплаты,
+// --min-hours=H, --min-salary=S – только сотрудники не ниже порога, по возрастанию id;
+//                 с --top порог применяется до выбора K лучших,
+// --io=auto|uring|threads|sync – чтение файла асинхронными запросами вместо отображения
+//                 в память: io_uring, пул потоков с pread или по одному запросу;
+//                 не сочетается с --memory и --incremental,
+// --group-by=name – вместо строк по сотрудникам итоги по каждому имени (коду команды):
+//                 число сотрудников, часы и зарплата; группировка идет в --threads потоков.
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        std::cerr << "Usage: Reporter <binary_file_name> <report_file_name> <hourly_rate>" << std::endl;
+    if (argc < 4) {
+        std::cerr << "Usage: Reporter <binary_file_name> <report_file_name> <hourly_rate> [binary_file_name...]"
+                  << " [--sort=std|parallel|radix] [--threads=N] [--memory=MiB]"
+                  << " [--report-threads=N] [--summary[=json_file]] [--incremental]"
+                  << " [--top=K] [--min-hours=H] [--min-salary=S]"
+                  << " [--io=auto|uring|threads|sync] [--group-by=name]" << std::endl;
         return 1;
     }
 
@@ -20,31 +330,210 @@ int main(int argc, char* argv[]) {
     const char* reportFilename = argv[2];
     double hourlyRate = std::atof(argv[3]);
 
+    SortAlgorithm sortAlgorithm = SORT_STD;
+    unsigned threads = 0;
+    size_t memoryBudget = 0;
+    unsigned reportThreads = 1;
+    bool summaryEnabled = false;
+    const char* summaryFilename = NULL;
+    bool incremental = false;
+    EmployeeQuery query;
+    AsyncBackend ioBackend = ASYNC_AUTO;
+    bool asyncRead = false;
+    bool groupByName = false;
+    std::vector<const char*> binFilenames(1, binFilename);
+    for (int i = 4; i < argc; i++) {
+        if (std::strncmp(argv[i], "--sort=", 7) == 0) {
+            if (!parseSortAlgorithm(argv[i] + 7, sortAlgorithm)) {
+                std::cerr << "Неизвестный алгоритм сортировки: " << argv[i] + 7 << std::endl;
+                return 1;
+            }
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = static_cast<unsigned>(std::atoi(argv[i] + 10));
+        } else if (std::strncmp(argv[i], "--report-threads=", 17) == 0) {
+            reportThreads = static_cast<unsigned>(std::atoi(argv[i] + 17));
+        } else if (std::strcmp(argv[i], "--incremental") == 0) {
+            incremental = true;
+        } else if (std::strncmp(argv[i], "--top=", 6) == 0) {
+            int top = std::atoi(argv[i] + 6);
+            if (top <= 0) {
+                std::cerr << "Число строк --top должно быть положительным." << std::endl;
+                return 1;
+            }
+            query.top = static_cast<size_t>(top);
+        } else if (std::strncmp(argv[i], "--min-hours=", 12) == 0) {
+            query.hasMinHours = true;
+            query.minHours = std::atof(argv[i] + 12);
+        } else if (std::strncmp(argv[i], "--min-salary=", 13) == 0) {
+            query.hasMinSalary = true;
+            query.minSalary = std::atof(argv[i] + 13);
+        } else if (std::strncmp(argv[i], "--io=", 5) == 0) {
+            if (!parseAsyncBackend(argv[i] + 5, ioBackend)) {
+                std::cerr << "Неизвестный способ чтения: " << argv[i] + 5 << std::endl;
+                return 1;
+            }
+            asyncRead = true;
+        } else if (std::strncmp(argv[i], "--group-by=", 11) == 0) {
+            if (std::strcmp(argv[i] + 11, "name") != 0) {
+                std::cerr << "Группировка возможна только по имени: " << argv[i] + 11 << std::endl;
+                return 1;
+            }
+            groupByName = true;
+        } else if (std::strcmp(argv[i], "--summary") == 0) {
+            summaryEnabled = true;
+        } else if (std::strncmp(argv[i], "--summary=", 10) == 0) {
+            summaryEnabled = true;
+            summaryFilename = argv[i] + 10;
+        } else if (std::strncmp(argv[i], "--", 2) != 0) {
+            binFilenames.push_back(argv[i]);
+        } else if (std::strncmp(argv[i], "--memory=", 9) == 0) {
+            double mebibytes = std::atof(argv[i] + 9);
+            if (mebibytes <= 0) {
+                std::cerr << "Бюджет памяти должен быть положительным." << std::endl;
+                return 1;
+            }
+            memoryBudget = static_cast<size_t>(mebibytes * 1024 * 1024);
+        } else {
+            std::cerr << "Неизвестный параметр: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    bool fromStdin = false;
+    for (size_t i = 0; i < binFilenames.size(); i++) {
+        if (std::strcmp(binFilenames[i], "-") == 0) fromStdin = true;
+    }
+    if (binFilenames.size() > 1 && (fromStdin || memoryBudget > 0 || incremental)) {
+        std::cerr << "Несколько файлов не сочетаются со стандартным вводом, --memory и --incremental."
+                  << std::endl;
+        return 1;
+    }
+    if (fromStdin && memoryBudget > 0) {
+        std::cerr << "Внешняя сортировка требует бинарного файла, а не стандартного ввода." << std::endl;
+        return 1;
+    }
+    if (fromStdin) {
+        // стандартный ввод читается потоком без перемотки
+        asyncRead = false;
+        std::ios::sync_with_stdio(false);
+        setBinaryMode(stdin);
+    }
+
+    ReportOptions options;
+    options.sort = sortAlgorithm;
+    options.sortThreads = threads;
+    options.reportThreads = reportThreads;
+
+    if (groupByName) {
+        if (memoryBudget > 0 || incremental || query.active()) {
+            std::cerr << "--group-by не сочетается с --memory, --incremental, --top и порогами." << std::endl;
+            return 1;
+        }
+        ReportWriter report(hourlyRate);
+        PayrollSummary summary(hourlyRate);
+        return runGrouped(binFilenames, reportFilename, report, summaryEnabled ? &summary : NULL,
+                          summaryFilename, options, asyncRead ? &ioBackend : NULL);
+    }
+
+    if (query.active()) {
+        if (memoryBudget > 0 || incremental) {
+            std::cerr << "--top и пороги не сочетаются с --memory и --incremental." << std::endl;
+            return 1;
+        }
+        ReportWriter report(hourlyRate);
+        PayrollSummary summary(hourlyRate);
+        return runQuery(binFilenames, reportFilename, query, report, summaryEnabled ? &summary : NULL,
+                        summaryFilename, options, asyncRead ? &ioBackend : NULL);
+    }
+
+    if (binFilenames.size() > 1) {
+        ReportWriter report(hourlyRate);
+        PayrollSummary summary(hourlyRate);
+        return runMerged(binFilenames, reportFilename, report, summaryEnabled ? &summary : NULL,
+                         summaryFilename, options, asyncRead ? &ioBackend : NULL);
+    }
+
+    if (incremental) {
+        if (fromStdin || memoryBudget > 0 || summaryEnabled || asyncRead) {
+            std::cerr << "--incremental не сочетается со стандартным вводом, --memory, --summary и --io."
+                      << std::endl;
+            return 1;
+        }
+        IncrementalReportStats stats;
+        if (!generateReportIncremental(binFilename, reportFilename, hourlyRate, options, &stats)) {
+            std::cerr << "Ошибка построения отчета." << std::endl;
+            return 1;
+        }
+        std::cout << (stats.rebuilt ? "Отчет построен заново" : "Отчет дополнен")
+                  << ", записей обработано: " << stats.newRecords << "." << std::endl;
+        return 0;
+    }
+
+    ReportWriter report(hourlyRate);
+    PayrollSummary summary(hourlyRate);
+
+    // внешняя сортировка: файл обрабатывается сериями в пределах бюджета памяти
+    if (memoryBudget > 0) {
+        if (asyncRead) {
+            std::cerr << "--memory не сочетается с --io: серии читаются потоком." << std::endl;
+            return 1;
+        }
+        if (!report.open(reportFilename)) {
+            std::cerr << "Ошибка создания файла отчета." << std::endl;
+            return 1;
+        }
+        report.writeHeader(binFilename);
+        SummaryWriter<ReportWriter> summaryWriter(report, summary);
+        bool sorted = summaryEnabled
+            ? externalSortEmployees(binFilename, memoryBudget, std::string(reportFilename),
+                                    sortAlgorithm, threads, summaryWriter)
+            : externalSortEmployees(binFilename, memoryBudget, std::string(reportFilename),
+                                    sortAlgorithm, threads, report);
+        if (!sorted) {
+            // недописанный отчет не должен выглядеть целым
+            report.close();
+            std::remove(reportFilename);
+            std::cerr << "Ошибка внешней сортировки бинарного файла." << std::endl;
+            return 1;
+        }
+        return finishReport(report, summaryEnabled ? &summary : NULL, summaryFilename);
+    }
+
+    EmployeeColumnView columns;
+    if (!fromStdin && !asyncRead && columns.open(binFilename)) {
+        return runColumnar(columns, binFilename, reportFilename, report, summaryEnabled ? &summary : NULL,
+                           summaryFilename);
+    }
+
     std::vector<Employee> employees;
-    if (!readEmployeeRecords(binFilename, employees)) {
+    EmployeeFileHeader header;
+    EmployeeFileView view;
+    bool summarized = false;
+    bool loaded;
+    if (!fromStdin && !asyncRead && view.open(binFilename)) {
+        // проверка суммы, копирование и итоги за один проход по отображению
+        LoadedRecordsSink sink(employees, summaryEnabled ? &summary : NULL);
+        employees.reserve(view.size());
+        loaded = view.verifyChecksum(sink);
+        header = view.header();
+        summarized = true;
+        view.close();
+    } else {
+        loaded = loadRecords(binFilename, employees, header, asyncRead ? &ioBackend : NULL);
+    }
+    if (!loaded) {
         std::cerr << "Ошибка чтения бинарного файла." << std::endl;
         return 1;
     }
 
-    // сортировка по id
-    sortEmployees(employees);
-
-    std::ofstream ofs(reportFilename);
-    if (!ofs) {
+    if (!report.open(reportFilename)) {
         std::cerr << "Ошибка создания файла отчета." << std::endl;
         return 1;
     }
 
-    ofs << "Отчет по файлу \"" << binFilename << "\"" << std::endl;
-    ofs << "Номер сотрудника\tИмя сотрудника\tЧасы\tЗарплата" << std::endl;
-    ofs << std::fixed << std::setprecision(2);
-    for (size_t i = 0; i < employees.size(); i++) {
-        double salary = employees[i].hours * hourlyRate;
-        ofs << employees[i].num << "\t" 
-            << employees[i].name << "\t" 
-            << employees[i].hours << "\t" 
-            << salary << std::endl;
-    }
-    ofs.close();
-    return 0;
-}
\ No newline at end of file
+    generateReport(employees, (header.flags & EMPLOYEE_FLAG_SORTED) != 0, binFilename, report, options);
+    // записи, раскодированные из другой раскладки или прочитанные асинхронно, уже
+    // лежат в памяти подряд: итоги по ним – отдельный проход векторным ядром
+    if (summaryEnabled && !summarized && !employees.empty()) summary.add(&employees[0], employees.size());
+    return finishReport(report, summaryEnabled ? &summary : NULL, summaryFilename);
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include "Employee.h"
+#include "EmployeeSort.h"
+#include "EmployeeGenerator.h"
+#include "Stopwatch.h"
+
+std::vector<Employee> makeEmployees(size_t count, uint64_t seed) {
+    GeneratorOptions options;
+    options.count = count;
+    options.ids = IDS_SHUFFLED;
+    options.seed = seed;
+    std::vector<Employee> employees(count);
+    if (count > 0) EmployeeGenerator(options).generate(0, &employees[0], count);
+    return employees;
+}
+
+// Сравнение алгоритмов сортировки Reporter на перемешанных id:
+// argv[1] – число записей (по умолчанию 10000000),
+// argv[2] – число потоков для параллельной сортировки (0 – по числу процессоров).
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? static_cast<size_t>(std::atof(argv[1])) : 10000000;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+    if (threads == 0) threads = hardwareThreadCount();
+
+    const std::vector<Employee> source = makeEmployees(count, 42);
+    const char* names[] = { "std", "parallel", "radix" };
+    const SortAlgorithm algorithms[] = { SORT_STD, SORT_PARALLEL, SORT_RADIX };
+
+    std::cout << "Записей: " << count << ", потоков: " << threads << std::endl;
+    double baseline = 0;
+    bool ok = true;
+    for (int a = 0; a < 3; a++) {
+        std::vector<Employee> employees(source);
+        double start = nowSeconds();
+        sortEmployees(employees, algorithms[a], threads);
+        double elapsed = nowSeconds() - start;
+        if (a == 0) baseline = elapsed;
+        bool sorted = employees.empty() || isSortedById(&employees[0], employees.size());
+        ok = ok && sorted;
+        std::cout << std::left << std::setw(10) << names[a] << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(10) << elapsed << " с"
+                  << std::setprecision(1) << std::setw(10) << (elapsed > 0 ? count / elapsed / 1e6 : 0) << " млн записей/с"
+                  << std::setprecision(2) << std::setw(8) << (elapsed > 0 ? baseline / elapsed : 0) << "x"
+                  << (sorted ? "" : "  ОШИБКА: не отсортировано") << std::endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+#ifndef STAGE_STATS_H
+#define STAGE_STATS_H
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <string>
+#include "Employee.h"
+#include "Stopwatch.h"
+#ifdef _WIN32
+#ifndef PSAPI_VERSION
+#define PSAPI_VERSION 2  // GetProcessMemoryInfo из kernel32, без psapi.lib
+#endif
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+// значение счетчика, который на этой системе недоступен
+const uint64_t STAGE_UNKNOWN = ~static_cast<uint64_t>(0);
+
+// ресурсы одной стадии работы Main
+struct StageStats {
+    std::string name;
+    bool child;             // отдельный процесс, иначе часть работы самого Main
+    double wallSeconds;
+    double userSeconds;
+    double systemSeconds;
+    uint64_t peakRssBytes;  // для стадии Main – пик процесса Main с момента запуска
+    uint64_t readBytes;     // через read(): из файлов, кэша и каналов
+    uint64_t writtenBytes;
+
+    explicit StageStats(const std::string& name = std::string(), bool child = false)
+        : name(name), child(child), wallSeconds(0), userSeconds(0), systemSeconds(0),
+          peakRssBytes(STAGE_UNKNOWN), readBytes(STAGE_UNKNOWN), writtenBytes(STAGE_UNKNOWN) {}
+};
+
+#ifndef _WIN32
+inline double timevalSeconds(const struct timeval& tv)
+{
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// ru_maxrss в Linux – в КиБ, в macOS – в байтах
+inline uint64_t maxRssBytes(const struct rusage& usage)
+{
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+inline void applyRusage(const struct rusage& usage, StageStats& stats)
+{
+    stats.userSeconds = timevalSeconds(usage.ru_utime);
+    stats.systemSeconds = timevalSeconds(usage.ru_stime);
+    stats.peakRssBytes = maxRssBytes(usage);
+}
+
+// Счетчики rchar/wchar из /proc/<process>/io (process – pid или "self").
+// false – файла нет (не Linux) или доступ к нему запрещен.
+inline bool readProcessIo(const std::string& process, uint64_t& readBytes, uint64_t& writtenBytes)
+{
+    std::ifstream ifs(("/proc/" + process + "/io").c_str());
+    std::string key;
+    unsigned long long value;
+    int found = 0;
+    while (ifs >> key >> value) {
+        if (key == "rchar:") {
+            readBytes = value;
+            found |= 1;
+        } else if (key == "wchar:") {
+            writtenBytes = value;
+            found |= 2;
+        }
+    }
+    return found == 3;
+}
+#else
+inline double fileTimeSeconds(const FILETIME& time)
+{
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return value.QuadPart * 1e-7;
+}
+
+// время, пиковый рабочий набор и байты ввода-вывода процесса по его описателю
+inline void applyProcessCounters(HANDLE process, StageStats& stats)
+{
+    FILETIME creation, exit, kernel, user;
+    if (GetProcessTimes(process, &creation, &exit, &kernel, &user)) {
+        stats.userSeconds = fileTimeSeconds(user);
+        stats.systemSeconds = fileTimeSeconds(kernel);
+    }
+    PROCESS_MEMORY_COUNTERS memory;
+    if (GetProcessMemoryInfo(process, &memory, sizeof(memory))) stats.peakRssBytes = memory.PeakWorkingSetSize;
+    IO_COUNTERS io;
+    if (GetProcessIoCounters(process, &io)) {
+        stats.readBytes = io.ReadTransferCount;
+        stats.writtenBytes = io.WriteTransferCount;
+    }
+}
+#endif
+
+// снимок счетчиков процесса Main
+inline StageStats takeSelfSnapshot()
+{
+    StageStats snapshot;
+    snapshot.wallSeconds = nowSeconds();
+#ifdef _WIN32
+    applyProcessCounters(GetCurrentProcess(), snapshot);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) applyRusage(usage, snapshot);
+    readProcessIo("self", snapshot.readBytes, snapshot.writtenBytes);
+#endif
+    return snapshot;
+}
+
+inline uint64_t counterDelta(uint64_t begin, uint64_t end)
+{
+    return begin == STAGE_UNKNOWN || end == STAGE_UNKNOWN || end < begin ? STAGE_UNKNOWN : end - begin;
+}
+
+// Стадии работы Main по порядку. Замеры дочерних процессов заполняет тот, кто
+// их ждет (wait4, на Windows – счетчики описателя процесса); часть работы
+// самого Main замеряется разностью снимков между begin() и end().
+// Выключенный журнал ничего не замеряет.
+class StageRecorder {
+public:
+    explicit StageRecorder(bool enabled = false) : enabled_(enabled) {}
+
+    bool enabled() const { return enabled_; }
+
+    void begin(const char* name) {
+        if (!enabled_) return;
+        name_ = name;
+        begin_ = takeSelfSnapshot();
+    }
+
+    void end() {
+        if (!enabled_) return;
+        StageStats end = takeSelfSnapshot();
+        StageStats stage(name_, false);
+        stage.wallSeconds = end.wallSeconds - begin_.wallSeconds;
+        stage.userSeconds = end.userSeconds - begin_.userSeconds;
+        stage.systemSeconds = end.systemSeconds - begin_.systemSeconds;
+        stage.peakRssBytes = end.peakRssBytes;
+        stage.readBytes = counterDelta(begin_.readBytes, end.readBytes);
+        stage.writtenBytes = counterDelta(begin_.writtenBytes, end.writtenBytes);
+        stages_.push_back(stage);
+    }
+
+    // место для итогов дочернего процесса; ссылки на элементы deque не
+    // меняются при добавлении, поэтому процессы могут работать одновременно
+    StageStats* child(const char* name) {
+        if (!enabled_) return NULL;
+        stages_.push_back(StageStats(name, true));
+        return &stages_.back();
+    }
+
+    const std::deque<StageStats>& stages() const { return stages_; }
+
+private:
+    bool enabled_;
+    std::string name_;
+    StageStats begin_;
+    std::deque<StageStats> stages_;
+};
+
+// дополнение пробелами до width символов UTF-8 (setw считает байты)
+inline std::string padStageCell(const std::string& text, size_t width, bool left)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) length++;
+    }
+    std::string padding(length < width ? width - length : 0, ' ');
+    return left ? text + padding : padding + text;
+}
+
+inline std::string formatStageNumber(double value, const char* format)
+{
+    char text[64];
+    std::sprintf(text, format, value);
+    return text;
+}
+
+inline std::string formatStageMebibytes(uint64_t bytes)
+{
+    return bytes == STAGE_UNKNOWN ? std::string("-") : formatStageNumber(bytes / 1048576.0, "%.2f");
+}
+
+// таблица итогов по стадиям
+inline std::string formatStageTable(const std::deque<StageStats>& stages)
+{
+    const char* const columns[] = { "Время, с", "CPU польз., с", "CPU сист., с", "Пик RSS, МиБ",
+                                    "Чтение, МиБ", "Запись, МиБ" };
+    std::string text = padStageCell("Стадия", 16, true);
+    for (size_t c = 0; c < sizeof(columns) / sizeof(columns[0]); c++) text += padStageCell(columns[c], 15, false);
+    text += "\n";
+    for (size_t i = 0; i < stages.size(); i++) {
+        const StageStats& stage = stages[i];
+        text += padStageCell(stage.name + (stage.child ? "" : "*"), 16, true);
+        text += padStageCell(formatStageNumber(stage.wallSeconds, "%.3f"), 15, false);
+        text += padStageCell(formatStageNumber(stage.userSeconds, "%.3f"), 15, false);
+        text += padStageCell(formatStageNumber(stage.systemSeconds, "%.3f"), 15, false);
+        text += padStageCell(formatStageMebibytes(stage.peakRssBytes), 15, false);
+        text += padStageCell(formatStageMebibytes(stage.readBytes), 15, false);
+        text += padStageCell(formatStageMebibytes(stage.writtenBytes), 15, false);
+        text += "\n";
+    }
+    return text + "* – работа самого Main; пик RSS – процесса Main с момента запуска\n";
+}
+
+inline std::string formatStageCounter(uint64_t value)
+{
+    if (value == STAGE_UNKNOWN) return "null";
+    char text[32];
+    std::sprintf(text, "%llu", static_cast<unsigned long long>(value));
+    return text;
+}
+
+// те же итоги в JSON
+inline std::string formatStageJson(const std::deque<StageStats>& stages)
+{
+    std::string text = "{\n  \"stages\": [\n";
+    for (size_t i = 0; i < stages.size(); i++) {
+        const StageStats& stage = stages[i];
+        text += "    { \"name\": \"" + stage.name + "\", \"child\": " + (stage.child ? "true" : "false") +
+                ", \"wall_seconds\": " + formatStageNumber(stage.wallSeconds, "%.6f") +
+                ", \"user_seconds\": " + formatStageNumber(stage.userSeconds, "%.6f") +
+                ", \"system_seconds\": " + formatStageNumber(stage.systemSeconds, "%.6f") +
+                ", \"peak_rss_bytes\": " + formatStageCounter(stage.peakRssBytes) +
+                ", \"read_bytes\": " + formatStageCounter(stage.readBytes) +
+                ", \"written_bytes\": " + formatStageCounter(stage.writtenBytes) + " }" +
+                (i + 1 < stages.size() ? "," : "") + "\n";
+    }
+    return text + "  ]\n}\n";
+}
+
+#endif // STAGE_STATS_H
@@ -2,8 +2,34 @@
 #include <vector>
 #include <cstring>
 #include <cstdlib>
+#include <climits>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
 #include "Employee.h"
+#include "EmployeeFileView.h"
+#include "EmployeeSort.h"
+#include "ExternalSort.h"
+#include "EmployeeIndex.h"
+#include "EmployeeFileWriter.h"
+#include "IdHashSet.h"
+#include "EmployeeGenerator.h"
+#include "Report.h"
+#include "EmployeeColumns.h"
+#include "PayrollSummary.h"
+#include "Payroll.h"
+#include "EmployeeCompression.h"
+#include "PayrollQuery.h"
+#include "EmployeeAsyncIO.h"
+#include "EmployeeFileReader.h"
+#include "EmployeeAppend.h"
+#include "PayrollGroups.h"
+#include "EmployeeBloom.h"
+#include "StageStats.h"
 
 bool testWriteReadEmployees() {
     std::vector<Employee> employees;
@@ -66,6 +92,1351 @@ bool testSortEmployees() {
     return true;
 }
 
+bool testEmployeeFileView() {
+    std::vector<Employee> employees;
+    for (int i = 0; i < 3; i++) {
+        Employee e;
+        std::memset(&e, 0, sizeof(e));
+        e.num = 10 - i;
+        std::strcpy(e.name, "Worker");
+        e.hours = 8.5 * i;
+        employees.push_back(e);
+    }
+
+    const char* testFilename = "test_view.bin";
+    if (!writeEmployeeRecords(testFilename, employees)) {
+        std::cerr << "Не удалось записать сотрудников." << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    {
+        EmployeeFileView view(testFilename);
+        if (!view.isOpen() || view.size() != employees.size()) {
+            std::cerr << "Неверное число записей в отображении." << std::endl;
+            ok = false;
+        }
+        for (size_t i = 0; ok && i < view.size(); i++) {
+            if (view[i].num != employees[i].num || view[i].hours != employees[i].hours ||
+                std::strcmp(view[i].name, employees[i].name) != 0) {
+                std::cerr << "Данные отображения не совпадают." << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    std::vector<Employee> loaded;
+    if (ok && (!loadEmployeeRecords(testFilename, loaded) || loaded.size() != employees.size())) {
+        std::cerr << "Не удалось загрузить сотрудников через отображение." << std::endl;
+        ok = false;
+    }
+    // записи дописываются к уже загруженным, как при чтении потоком
+    if (ok && (!loadEmployeeRecords(testFilename, loaded) || loaded.size() != 2 * employees.size() ||
+               loaded.back().num != employees.back().num || loaded[0].num != employees[0].num)) {
+        std::cerr << "Повторная загрузка не дописала записи в конец." << std::endl;
+        ok = false;
+    }
+
+    EmployeeFileView missing;
+    if (missing.open("no_such_file.bin")) {
+        std::cerr << "Открыт несуществующий файл." << std::endl;
+        ok = false;
+    }
+    std::remove(testFilename);
+    return ok;
+}
+
+bool testSortAlgorithms() {
+    // достаточно записей, чтобы параллельная сортировка разбила их на куски
+    const size_t count = PARALLEL_SORT_MIN_CHUNK * 4 + 123;
+    std::vector<Employee> source(count);
+    unsigned int state = 12345;
+    for (size_t i = 0; i < count; i++) {
+        state = state * 1103515245u + 12345u;
+        source[i].num = static_cast<int>(state) - 1000000;
+        std::strcpy(source[i].name, "Test");
+        source[i].hours = static_cast<double>(i);
+    }
+    std::vector<Employee> expected(source);
+    sortEmployees(expected);
+
+    const SortAlgorithm algorithms[] = { SORT_PARALLEL, SORT_RADIX };
+    for (int a = 0; a < 2; a++) {
+        for (unsigned threads = 1; threads <= 5; threads += 2) {
+            std::vector<Employee> employees(source);
+            sortEmployees(employees, algorithms[a], threads);
+            for (size_t i = 0; i < count; i++) {
+                if (employees[i].num != expected[i].num) {
+                    std::cerr << "Сортировка алгоритмом " << a << " не удалась." << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    SortAlgorithm parsed;
+    if (!parseSortAlgorithm("radix", parsed) || parsed != SORT_RADIX || parseSortAlgorithm("quick", parsed)) {
+        std::cerr << "Неверный разбор имени алгоритма." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// приемник записей для проверки внешней сортировки
+struct CollectingWriter {
+    std::vector<Employee> records;
+    bool write(const Employee& emp) {
+        records.push_back(emp);
+        return true;
+    }
+};
+
+bool testExternalSort() {
+    // несколько серий по минимальному размеру буфера
+    const size_t count = EXTERNAL_SORT_MIN_RUN_BUFFER * 5 + 7;
+    std::vector<Employee> employees(count);
+    unsigned int state = 777;
+    for (size_t i = 0; i < count; i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        state = state * 1103515245u + 12345u;
+        employees[i].num = static_cast<int>(state >> 8);
+        std::strcpy(employees[i].name, "Ext");
+        employees[i].hours = static_cast<double>(i % 100);
+    }
+    const char* testFilename = "test_external.bin";
+    if (!writeEmployeeRecords(testFilename, employees)) {
+        std::cerr << "Не удалось записать сотрудников." << std::endl;
+        return false;
+    }
+
+    CollectingWriter writer;
+    bool ok = externalSortEmployees(testFilename, 1, "test_external", SORT_STD, 1, writer);
+    std::remove(testFilename);
+    if (!ok || writer.records.size() != count) {
+        std::cerr << "Внешняя сортировка не удалась." << std::endl;
+        return false;
+    }
+    sortEmployees(employees);
+    for (size_t i = 0; i < count; i++) {
+        if (writer.records[i].num != employees[i].num) {
+            std::cerr << "Внешняя сортировка нарушила порядок." << std::endl;
+            return false;
+        }
+    }
+    std::ifstream leftover("test_external.run0");
+    if (leftover) {
+        std::cerr << "Временные файлы серий не удалены." << std::endl;
+        return false;
+    }
+
+    // отсортированный файл с поврежденной записью в конце отвергается до первой записи в writer
+    CollectingWriter presorted;
+    bool written = writeEmployeeRecords(testFilename, employees);
+    {
+        std::fstream fs(testFilename, std::ios::in | std::ios::out | std::ios::binary);
+        fs.seekp(sizeof(EmployeeFileHeader) + (count - 2) * sizeof(Employee) + offsetof(Employee, hours));
+        double hours = 1234.5;
+        fs.write(reinterpret_cast<const char*>(&hours), sizeof(hours));
+    }
+    ok = written && !externalSortEmployees(testFilename, 1, "test_external", SORT_STD, 1, presorted);
+    std::remove(testFilename);
+    if (!ok || !presorted.records.empty()) {
+        std::cerr << "Поврежденный отсортированный файл частично передан в отчет." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool testEmployeeFileHeader() {
+    std::vector<Employee> employees(3);
+    for (int i = 0; i < 3; i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = i + 1;
+        std::strcpy(employees[i].name, "Sorted");
+        employees[i].hours = 10.0 * i;
+    }
+    const char* testFilename = "test_header.bin";
+    if (!writeEmployeeRecords(testFilename, employees)) {
+        std::cerr << "Не удалось записать сотрудников." << std::endl;
+        return false;
+    }
+
+    // заголовок: число записей, версия и флаг сортировки
+    std::vector<Employee> readEmployees;
+    EmployeeFileHeader header;
+    if (!readEmployeeRecords(testFilename, readEmployees, &header) ||
+        header.version != EMPLOYEE_FILE_VERSION || header.recordCount != 3 ||
+        (header.flags & EMPLOYEE_FLAG_SORTED) == 0) {
+        std::cerr << "Неверный заголовок файла." << std::endl;
+        return false;
+    }
+
+    // поврежденная запись отвергается по контрольной сумме
+    {
+        std::fstream fs(testFilename, std::ios::in | std::ios::out | std::ios::binary);
+        fs.seekp(sizeof(EmployeeFileHeader) + sizeof(Employee) + offsetof(Employee, hours));
+        double hours = 99.0;
+        fs.write(reinterpret_cast<const char*>(&hours), sizeof(hours));
+    }
+    readEmployees.clear();
+    if (readEmployeeRecords(testFilename, readEmployees) || loadEmployeeRecords(testFilename, readEmployees)) {
+        std::cerr << "Поврежденный файл не обнаружен." << std::endl;
+        return false;
+    }
+
+    // обрезанный файл отвергается
+    std::swap(employees[0], employees[2]);
+    writeEmployeeRecords(testFilename, employees);
+    {
+        std::ifstream ifs(testFilename, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        ifs.close();
+        std::ofstream ofs(testFilename, std::ios::binary);
+        ofs.write(&bytes[0], bytes.size() - sizeof(Employee));
+    }
+    EmployeeFileView view;
+    if (readEmployeeRecords(testFilename, readEmployees) || view.open(testFilename)) {
+        std::cerr << "Обрезанный файл не обнаружен." << std::endl;
+        return false;
+    }
+
+    // файл старого формата без заголовка читается как раньше
+    {
+        std::ofstream ofs(testFilename, std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(&employees[0]), employees.size() * sizeof(Employee));
+    }
+    readEmployees.clear();
+    if (!readEmployeeRecords(testFilename, readEmployees, &header) || header.version != 0 ||
+        readEmployees.size() != 3 || readEmployees[0].num != 3 || !view.open(testFilename) || view.size() != 3) {
+        std::cerr << "Файл без заголовка не прочитан." << std::endl;
+        return false;
+    }
+    view.close();
+    std::remove(testFilename);
+    return true;
+}
+
+bool testEmployeeIndex() {
+    std::vector<Employee> employees;
+    const int ids[] = { 50, -3, 17, 8, 17, 100 };
+    for (int i = 0; i < 6; i++) {
+        Employee e;
+        std::memset(&e, 0, sizeof(e));
+        e.num = ids[i];
+        std::strcpy(e.name, "Idx");
+        e.hours = i;
+        employees.push_back(e);
+    }
+    const char* testFilename = "test_index.bin";
+    const char* indexFilename = "test_index.bin.idx";
+    writeEmployeeRecords(testFilename, employees);
+
+    EmployeeFileView view(testFilename);
+    EmployeeIndex index;
+    bool ok = buildEmployeeIndex(view, indexFilename) && index.open(indexFilename) &&
+              index.matches(view) && index.size() == employees.size();
+    std::vector<EmployeeIndexEntry> found;
+    if (ok) {
+        index.find(17, found);
+        ok = found.size() == 2 &&
+             employeeAtOffset(view, found[0].offset)->hours == 2 &&
+             employeeAtOffset(view, found[1].offset)->hours == 4 &&
+             employeeIndexRangeMatches(view, found, 17, 17) && index.contains(17) && !index.contains(9);
+        index.range(-5, 10, found);
+        ok = ok && found.size() == 2 && found[0].num == -3;
+        index.find(9, found);
+        ok = ok && found.empty();
+    }
+    if (!ok) {
+        std::cerr << "Поиск по индексу не удался." << std::endl;
+    }
+
+    // после перезаписи файла индекс считается устаревшим
+    employees.pop_back();
+    writeEmployeeRecords(testFilename, employees);
+    EmployeeFileView changed(testFilename);
+    if (ok && index.matches(changed)) {
+        std::cerr << "Устаревший индекс не обнаружен." << std::endl;
+        ok = false;
+    }
+
+    // файл без заголовка перезаписан на месте той же длины: индекс отвергается
+    // по времени изменения, а если оно совпало – при сверке найденных записей
+    view.close();
+    changed.close();
+    {
+        std::ofstream ofs(testFilename, std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(&employees[0]), employees.size() * sizeof(Employee));
+    }
+    ok = ok && view.open(testFilename) && buildEmployeeIndex(view, indexFilename) && index.open(indexFilename) &&
+         index.matches(view);
+    view.close();
+    std::swap(employees[0].num, employees[1].num);
+    {
+        std::ofstream ofs(testFilename, std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(&employees[0]), employees.size() * sizeof(Employee));
+    }
+    if (ok && changed.open(testFilename)) {
+        index.find(50, found);
+        if (index.matches(changed) && employeeIndexRangeMatches(changed, found, 50, 50)) {
+            std::cerr << "Устаревший индекс файла без заголовка не обнаружен." << std::endl;
+            ok = false;
+        }
+    }
+    changed.close();
+    std::remove(testFilename);
+    std::remove(indexFilename);
+    return ok;
+}
+
+bool testEmployeeIdSet() {
+    EmployeeIdSet ids;
+    for (int i = -500; i < 500; i++) {
+        if (!ids.insert(i * 7)) {
+            std::cerr << "Новый id не добавлен." << std::endl;
+            return false;
+        }
+    }
+    if (ids.insert(14) || ids.size() != 1000 || !ids.contains(-3500) || ids.contains(15)) {
+        std::cerr << "Множество id работает неверно." << std::endl;
+        return false;
+    }
+    // значение пустой ячейки тоже допустимый id
+    if (ids.contains(INT_MIN) || !ids.insert(INT_MIN) || ids.insert(INT_MIN) || !ids.contains(INT_MIN)) {
+        std::cerr << "Неверная обработка id INT_MIN." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool testEmployeeFileWriter() {
+    const char* testFilename = "test_writer.bin";
+    const size_t count = EMPLOYEE_WRITER_CHUNK + 10;
+    std::vector<Employee> employees(count);
+    EmployeeFileWriter writer;
+    if (!writer.open(testFilename)) {
+        std::cerr << "Не удалось открыть файл для записи." << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(i);
+        std::strcpy(employees[i].name, "Chunk");
+        employees[i].hours = 0.5 * i;
+        writer.write(employees[i]);
+    }
+    if (!writer.close()) {
+        std::cerr << "Не удалось записать сотрудников блоками." << std::endl;
+        return false;
+    }
+
+    std::vector<Employee> readEmployees;
+    EmployeeFileHeader header;
+    bool ok = readEmployeeRecords(testFilename, readEmployees, &header) &&
+              readEmployees.size() == count && (header.flags & EMPLOYEE_FLAG_SORTED) != 0 &&
+              readEmployees[count - 1].hours == employees[count - 1].hours;
+    std::remove(testFilename);
+    if (!ok) {
+        std::cerr << "Файл, записанный блоками, прочитан неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testEmployeeGenerator() {
+    GeneratorOptions options;
+    options.count = GENERATOR_BLOCK * 2 + 501;
+    options.ids = IDS_SHUFFLED;
+    options.names = NAMES_ZIPF;
+    options.hours = HOURS_NORMAL;
+    options.seed = 7;
+
+    // один и тот же seed дает один и тот же файл при любом числе потоков
+    const char* firstFilename = "test_gen1.bin";
+    const char* secondFilename = "test_gen2.bin";
+    options.threads = 1;
+    bool ok = generateEmployeeFile(firstFilename, options);
+    options.threads = 3;
+    ok = ok && generateEmployeeFile(secondFilename, options);
+
+    std::vector<Employee> first, second;
+    ok = ok && readEmployeeRecords(firstFilename, first) && readEmployeeRecords(secondFilename, second) &&
+         first.size() == options.count && second.size() == options.count &&
+         std::memcmp(&first[0], &second[0], first.size() * sizeof(Employee)) == 0;
+    std::remove(firstFilename);
+    std::remove(secondFilename);
+    if (!ok) {
+        std::cerr << "Генерация не воспроизводится." << std::endl;
+        return false;
+    }
+
+    // перемешанные id – перестановка 1..N, часы в допустимых пределах
+    std::vector<bool> seen(first.size() + 1, false);
+    for (size_t i = 0; i < first.size(); i++) {
+        int id = first[i].num;
+        if (id < 1 || static_cast<size_t>(id) > first.size() || seen[id] ||
+            first[i].hours < 0 || first[i].hours > options.maxHours || std::strlen(first[i].name) < 3) {
+            std::cerr << "Сгенерирована неверная запись." << std::endl;
+            return false;
+        }
+        seen[id] = true;
+    }
+
+    // убывающие id
+    options.ids = IDS_DESCENDING;
+    options.count = 5;
+    EmployeeGenerator generator(options);
+    Employee emp;
+    generator.generate(0, emp);
+    if (emp.num != 5) {
+        std::cerr << "Неверные убывающие id." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool testReportFormat() {
+    const double values[] = { 0.0, -0.0, 7.25, 0.125, 0.375, 2.675, 1.005, 99.995, -5.5, -0.001,
+                              123456789.125, 1e300, -1e300, std::numeric_limits<double>::infinity() };
+    const int ids[] = { 0, -1, 42, 2147483647, -2147483647 - 1 };
+    for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+        Employee emp;
+        std::memset(&emp, 0, sizeof(emp));
+        emp.num = ids[v % 5];
+        std::strcpy(emp.name, v % 2 ? "Alice" : "Bartholom");
+        emp.hours = values[v];
+
+        // эталон – форматирование потоком, как раньше делал Reporter
+        std::ostringstream expected;
+        expected << std::fixed << std::setprecision(2);
+        expected << emp.num << "\t" << emp.name << "\t" << emp.hours << "\t" << emp.hours * 3.7 << "\n";
+
+        char line[REPORT_MAX_LINE];
+        char* end = formatReportLine(line, emp, 3.7);
+        if (std::string(line, end) != expected.str()) {
+            std::cerr << "Строка отчета отличается: " << std::string(line, end);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string readWholeFile(const char* filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+}
+
+bool testParallelReport() {
+    GeneratorOptions options;
+    options.count = REPORT_CHUNK * 7 + 3;
+    std::vector<Employee> employees(options.count);
+    EmployeeGenerator(options).generate(0, &employees[0], employees.size());
+
+    const char* sequentialFilename = "test_report1.txt";
+    const char* parallelFilename = "test_report2.txt";
+    ReportWriter sequential(12.5);
+    bool ok = sequential.open(sequentialFilename);
+    sequential.writeHeader("test.bin");
+    ok = ok && sequential.write(&employees[0], employees.size()) && sequential.close();
+
+    for (unsigned threads = 2; ok && threads <= 4; threads++) {
+        ReportWriter parallel(12.5);
+        ok = parallel.open(parallelFilename);
+        parallel.writeHeader("test.bin");
+        ok = ok && writeReportParallel(parallel, &employees[0], employees.size(), threads) && parallel.close();
+        ok = ok && readWholeFile(sequentialFilename) == readWholeFile(parallelFilename);
+    }
+    std::remove(sequentialFilename);
+    std::remove(parallelFilename);
+    if (!ok) {
+        std::cerr << "Параллельный отчет отличается от последовательного." << std::endl;
+    }
+    return ok;
+}
+
+bool testPackedFormat() {
+    std::vector<Employee> employees(7);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(i * 1000) - 3000;
+        std::strcpy(employees[i].name, i % 2 ? "Packed" : "Ninechars");
+        employees[i].hours = 1.25 * i;
+    }
+
+    // упаковка не зависит от порядка байтов платформы
+    unsigned char bytes[PACKED_EMPLOYEE_SIZE];
+    encodePackedEmployee(employees[0], bytes);
+    if (bytes[0] != 0x48 || bytes[1] != 0xF4 || bytes[2] != 0xFF || bytes[3] != 0xFF || bytes[4] != 'N') {
+        std::cerr << "Неверная упаковка записи." << std::endl;
+        return false;
+    }
+
+    const char* testFilename = "test_packed.bin";
+    bool ok = writeEmployeeRecords(testFilename, employees, EMPLOYEE_FORMAT_PACKED) &&
+              readWholeFile(testFilename).size() == sizeof(EmployeeFileHeader) + employees.size() * PACKED_EMPLOYEE_SIZE;
+
+    // потоковая запись кусками произвольной длины дает тот же файл
+    EmployeeFileWriter writer;
+    ok = ok && writer.open("test_packed2.bin", EMPLOYEE_FORMAT_PACKED) &&
+         writer.write(&employees[0], 3) && writer.write(employees[3]) &&
+         writer.write(&employees[4], 3) && writer.close() &&
+         readWholeFile(testFilename) == readWholeFile("test_packed2.bin");
+
+    std::vector<Employee> readEmployees, loaded;
+    EmployeeFileHeader header;
+    ok = ok && readEmployeeRecords(testFilename, readEmployees, &header) &&
+         header.format == EMPLOYEE_FORMAT_PACKED && readEmployees.size() == employees.size() &&
+         loadEmployeeRecords(testFilename, loaded) && loaded.size() == employees.size();
+    for (size_t i = 0; ok && i < employees.size(); i++) {
+        ok = std::memcmp(&readEmployees[i], &employees[i], sizeof(Employee)) == 0 &&
+             std::memcmp(&loaded[i], &employees[i], sizeof(Employee)) == 0;
+    }
+    std::remove(testFilename);
+    std::remove("test_packed2.bin");
+    if (!ok) {
+        std::cerr << "Упакованный файл прочитан неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testColumnarFormat() {
+    std::vector<Employee> employees(5);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = 10 - static_cast<int>(i);
+        std::strcpy(employees[i].name, i % 2 ? "Col" : "Columnar");
+        employees[i].hours = 0.5 + i;
+    }
+
+    // 5 * (4 + 10) байт колонок num и name выравниваются до 8 перед hours
+    const char* testFilename = "test_columnar.bin";
+    bool ok = writeEmployeeRecords(testFilename, employees, EMPLOYEE_FORMAT_COLUMNAR) &&
+              readWholeFile(testFilename).size() == sizeof(EmployeeFileHeader) + 72 + 5 * sizeof(double);
+
+    EmployeeFileWriter writer;
+    ok = ok && !writer.open("test_columnar2.bin", EMPLOYEE_FORMAT_COLUMNAR);
+
+    std::vector<Employee> readEmployees;
+    EmployeeFileHeader header;
+    ok = ok && readEmployeeRecords(testFilename, readEmployees, &header) &&
+         header.format == EMPLOYEE_FORMAT_COLUMNAR && readEmployees.size() == employees.size();
+    for (size_t i = 0; ok && i < employees.size(); i++) {
+        ok = std::memcmp(&readEmployees[i], &employees[i], sizeof(Employee)) == 0;
+    }
+
+    EmployeeColumnView view;
+    ok = ok && view.open(testFilename) && view.size() == employees.size() && view.verifyChecksum() &&
+         view.num()[4] == 6 && std::strcmp(view.name(1), "Col") == 0 && view.hours()[2] == 2.5 &&
+         view.sorted() == false;
+    PayrollSummary summary(2.0);
+    if (ok) summary.addHours(view.hours(), view.size());
+    ok = ok && summary.totalPayroll() == 25.0;
+
+    // отчет по колонкам совпадает с отчетом по тем же записям в раскладке Employee
+    // (кроме строки с именем файла) для неотсортированного и отсортированного файла
+    for (int pass = 0; ok && pass < 2; pass++) {
+        std::vector<Employee> records(employees);
+        if (pass == 1) std::reverse(records.begin(), records.end());
+        ok = writeEmployeeRecords("test_columnar3.bin", records, EMPLOYEE_FORMAT_COLUMNAR) &&
+             writeEmployeeRecords("test_columnar_native.bin", records) &&
+             generateReport("test_columnar3.bin", "test_columnar.txt", 2.0) &&
+             generateReport("test_columnar_native.bin", "test_columnar_native.txt", 2.0);
+        std::string columnar = readWholeFile("test_columnar.txt");
+        std::string native = readWholeFile("test_columnar_native.txt");
+        ok = ok && columnar.substr(columnar.find('\n')) == native.substr(native.find('\n')) &&
+             native.find("6\tColumnar\t4.50\t9.00\n7\tCol\t") != std::string::npos;
+    }
+
+    // колонки, записанные напрямую, дают тот же файл
+    EmployeeColumns columns;
+    ok = ok && readEmployeeColumns(testFilename, columns) && columns.size() == employees.size() &&
+         writeEmployeeColumns("test_columnar2.bin", columns) &&
+         readWholeFile(testFilename) == readWholeFile("test_columnar2.bin");
+
+    double salaries[5];
+    computeSalaries(&columns.hours[0], columns.size(), 3.0, salaries);
+    ok = ok && salaries[4] == 13.5 && columns.at(3).num == 7;
+
+    std::remove(testFilename);
+    std::remove("test_columnar2.bin");
+    std::remove("test_columnar3.bin");
+    std::remove("test_columnar_native.bin");
+    std::remove("test_columnar.txt");
+    std::remove("test_columnar_native.txt");
+    if (!ok) {
+        std::cerr << "Колоночный файл прочитан неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testPayrollSummary() {
+    // четверти часа складываются без округления – все ядра обязаны совпасть точно
+    std::vector<Employee> employees(1003);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(i);
+        employees[i].hours = static_cast<double>((i * 37) % 1400) * 0.25 - 10;
+    }
+    employees[500].hours = 1e12;
+
+    PayrollSummary scalar(2.0, accumulateHoursScalar);
+    scalar.add(&employees[0], employees.size());
+    std::vector<HoursKernel> kernels;
+    kernels.push_back(hoursKernel());
+#ifdef PAYROLL_HAS_SSE2
+    kernels.push_back(accumulateHoursSse2);
+#endif
+#ifdef PAYROLL_HAS_AVX2
+    if (__builtin_cpu_supports("avx2")) kernels.push_back(accumulateHoursAvx2);
+#endif
+    for (size_t k = 0; k < kernels.size(); k++) {
+        PayrollSummary summary(2.0, kernels[k]);
+        summary.add(&employees[0], employees.size());
+        if (std::memcmp(&summary.aggregate(), &scalar.aggregate(), sizeof(HoursAggregate)) != 0) {
+            std::cerr << "Ядро сводки " << k << " расходится со скалярным." << std::endl;
+            return false;
+        }
+    }
+
+    double expectedSum = 0;
+    uint64_t binTotal = 0;
+    for (size_t i = 0; i < employees.size(); i++) expectedSum += employees[i].hours;
+    for (size_t bin = 0; bin < SUMMARY_BINS; bin++) binTotal += scalar.aggregate().bins[bin];
+    bool ok = scalar.count() == employees.size() && binTotal == employees.size() &&
+              scalar.totalHours() == expectedSum && scalar.totalPayroll() == expectedSum * 2 &&
+              scalar.minHours() == -10 && scalar.maxHours() == 1e12 &&
+              scalar.aggregate().bins[SUMMARY_BINS - 1] >= 1 && summaryBin(-5) == 0 && summaryBin(45) == 2;
+
+    // итоги, собранные в проходе проверки суммы файла, совпадают с итогами по записям
+    std::vector<Employee> tripled;
+    for (int copy = 0; copy < 3; copy++) tripled.insert(tripled.end(), employees.begin(), employees.end());
+    PayrollSummary direct(2.0);
+    direct.add(&tripled[0], tripled.size());
+    for (int format = 0; ok && format < 2; format++) {
+        const char* testFilename = "test_summary.bin";
+        ok = writeEmployeeRecords(testFilename, tripled, format == 0 ? EMPLOYEE_FORMAT_NATIVE
+                                                                     : EMPLOYEE_FORMAT_COLUMNAR);
+        {
+            PayrollSummary fromFile(2.0);
+            EmployeeFileView view;
+            EmployeeColumnView columns;
+            ok = ok &&
+                 (format == 0 ? view.open(testFilename) && view.verifyChecksum(fromFile)
+                              : columns.open(testFilename) && columns.verifyChecksum(fromFile)) &&
+                 std::memcmp(&fromFile.aggregate(), &direct.aggregate(), sizeof(HoursAggregate)) == 0;
+        }
+        std::remove(testFilename);
+    }
+
+    PayrollSummary empty(1.0);
+    ok = ok && empty.count() == 0 && empty.minHours() == 0 && empty.averageHours() == 0 &&
+         formatSummaryJson(empty).find("\"count\": 0,") != std::string::npos;
+    if (!ok) {
+        std::cerr << "Неверные итоги по фонду оплаты." << std::endl;
+    }
+    return ok;
+}
+
+bool testEmployeeStream() {
+    std::vector<Employee> employees(100001);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(employees.size() - i);
+        std::strcpy(employees[i].name, "Stream");
+        employees[i].hours = i * 0.5;
+    }
+    const char* testFilename = "test_stream.bin";
+    if (!writeEmployeeRecords(testFilename, employees, EMPLOYEE_FORMAT_PACKED)) return false;
+
+    // поток без заголовка – как из Creator в "-", с неполной записью в конце
+    std::string raw(reinterpret_cast<const char*>(&employees[0]), employees.size() * sizeof(Employee));
+    std::istringstream legacy(raw + "xyz");
+    std::ifstream packed(testFilename, std::ios::binary);
+    std::vector<Employee> fromLegacy, fromPacked;
+    EmployeeFileHeader legacyHeader, packedHeader;
+    bool ok = readEmployeeStream(legacy, fromLegacy, &legacyHeader) &&
+              readEmployeeStream(packed, fromPacked, &packedHeader) &&
+              legacyHeader.version == 0 && legacyHeader.recordCount == employees.size() &&
+              packedHeader.format == EMPLOYEE_FORMAT_PACKED &&
+              fromLegacy.size() == employees.size() && fromPacked.size() == employees.size() &&
+              std::memcmp(&fromLegacy[0], &employees[0], raw.size()) == 0 &&
+              std::memcmp(&fromPacked[0], &employees[0], raw.size()) == 0;
+
+    std::istringstream empty("");
+    std::vector<Employee> none;
+    ok = ok && readEmployeeStream(empty, none) && none.empty();
+    std::remove(testFilename);
+    if (!ok) {
+        std::cerr << "Поток записей прочитан неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testPayrollLibrary() {
+    // создание файла из таблицы и отчет по нему без запуска утилит
+    std::istringstream csv("id;name;hours\n7;Gina;10\n3;Ivan;2.5\n7;Dup;1\nbad line\n5;Olga;4\n");
+    const char* testFilename = "test_library.bin";
+    EmployeeFileWriter writer;
+    ImportStats stats;
+    bool ok = writer.open(testFilename) && createEmployees(csv, writer, stats) && writer.close() &&
+              stats.records == 3 && stats.duplicates == 1 && stats.errors == 1;
+
+    std::ifstream bin(testFilename, std::ios::binary);
+    std::ostringstream report;
+    ok = ok && generateReport(bin, report, "lib", 2.0) &&
+         report.str() == "Отчет по файлу \"lib\"\nНомер сотрудника\tИмя сотрудника\tЧасы\tЗарплата\n"
+                         "3\tIvan\t2.50\t5.00\n5\tOlga\t4.00\t8.00\n7\tGina\t10.00\t20.00\n";
+
+    // повторное использование writer и буфера записей для нескольких файлов
+    ReportWriter reportWriter(2.0);
+    std::vector<Employee> employees;
+    ok = ok && generateReport(testFilename, "test_library1.txt", reportWriter, employees) &&
+         generateReport(testFilename, "test_library2.txt", reportWriter, employees) &&
+         !generateReport("test_library_missing.bin", "test_library3.txt", reportWriter, employees) &&
+         readWholeFile("test_library1.txt") == readWholeFile("test_library2.txt") &&
+         readWholeFile("test_library1.txt").find("7\tGina\t10.00\t20.00\n") != std::string::npos;
+    std::remove(testFilename);
+    std::remove("test_library1.txt");
+    std::remove("test_library2.txt");
+    if (!ok) {
+        std::cerr << "Библиотека Payroll работает неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testIncrementalReport() {
+    std::vector<Employee> employees(9);
+    const int ids[] = { 40, 10, 30, 20, 50, 60, 70, 25, 5 };
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = ids[i];
+        std::strcpy(employees[i].name, "Inc");
+        employees[i].hours = i + 0.5;
+    }
+    const char* binFilename = "test_incremental.bin";
+    const char* reportFilename = "test_incremental.txt";
+    std::vector<Employee> part(employees.begin(), employees.begin() + 4);
+    IncrementalReportStats stats;
+    bool ok = writeEmployeeRecords(binFilename, part) &&
+              generateReportIncremental(binFilename, reportFilename, 2.0, ReportOptions(), &stats) &&
+              stats.rebuilt && stats.newRecords == 4;
+
+    // дописаны id больше прежних – строки добавляются в конец
+    part.assign(employees.begin(), employees.begin() + 7);
+    ok = ok && writeEmployeeRecords(binFilename, part) &&
+         generateReportIncremental(binFilename, reportFilename, 2.0, ReportOptions(), &stats) &&
+         !stats.rebuilt && !stats.merged && stats.newRecords == 3 &&
+         generateReport(binFilename, "test_incremental_full.txt", 2.0) &&
+         readWholeFile(reportFilename) == readWholeFile("test_incremental_full.txt");
+
+    // дописаны id меньше прежних – слияние со старым отчетом
+    ok = ok && writeEmployeeRecords(binFilename, employees) &&
+         generateReportIncremental(binFilename, reportFilename, 2.0, ReportOptions(), &stats) &&
+         !stats.rebuilt && stats.merged && stats.newRecords == 2 &&
+         generateReport(binFilename, "test_incremental_full.txt", 2.0) &&
+         readWholeFile(reportFilename) == readWholeFile("test_incremental_full.txt");
+
+    // все дописанные id меньше прежних – ни одна новая строка не остается после старых
+    for (int i = 0; i < 2; i++) {
+        Employee e;
+        std::memset(&e, 0, sizeof(e));
+        e.num = 2 - i;
+        std::strcpy(e.name, "Early");
+        e.hours = 1.25;
+        employees.push_back(e);
+    }
+    ok = ok && writeEmployeeRecords(binFilename, employees) &&
+         generateReportIncremental(binFilename, reportFilename, 2.0, ReportOptions(), &stats) &&
+         !stats.rebuilt && stats.merged && stats.newRecords == 2 &&
+         generateReport(binFilename, "test_incremental_full.txt", 2.0) &&
+         readWholeFile(reportFilename) == readWholeFile("test_incremental_full.txt");
+
+    // повторный запуск без новых записей ничего не меняет
+    ok = ok && generateReportIncremental(binFilename, reportFilename, 2.0, ReportOptions(), &stats) &&
+         !stats.rebuilt && stats.newRecords == 0;
+
+    // измененное начало файла или новая оплата – отчет строится заново
+    employees[0].hours = 99;
+    ok = ok && writeEmployeeRecords(binFilename, employees) &&
+         generateReportIncremental(binFilename, reportFilename, 2.0, ReportOptions(), &stats) && stats.rebuilt &&
+         generateReportIncremental(binFilename, reportFilename, 3.0, ReportOptions(), &stats) && stats.rebuilt &&
+         generateReport(binFilename, "test_incremental_full.txt", 3.0) &&
+         readWholeFile(reportFilename) == readWholeFile("test_incremental_full.txt");
+
+    std::remove(binFilename);
+    std::remove(reportFilename);
+    std::remove("test_incremental.txt.state");
+    std::remove("test_incremental_full.txt");
+    if (!ok) {
+        std::cerr << "Инкрементальный отчет построен неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testCompressedFormat() {
+    // два блока: в первом часы с точностью до сотых, во втором – произвольные double
+    std::vector<Employee> employees(COMPRESSED_BLOCK + 1000);
+    const char* names[] = { "Anna", "Boris", "Ninechars", "" };
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = i % 7 == 0 ? -static_cast<int>(i) : static_cast<int>(i * 3);
+        std::strcpy(employees[i].name, names[i % 4]);
+        employees[i].hours = i < COMPRESSED_BLOCK ? (i % 1000) * 0.25 - 3 : 1.0 / (i + 1);
+    }
+    employees[5].num = INT_MIN;
+    employees[6].num = INT_MAX;
+    std::memcpy(employees[9].name, "TenLetters", 10);
+
+    const char* testFilename = "test_compressed.bin";
+    std::vector<Employee> loaded, direct;
+    EmployeeFileHeader header;
+    bool ok = writeEmployeeCompressed(testFilename, &employees[0], employees.size(), 2) &&
+              readWholeFile(testFilename).size() < employees.size() * sizeof(Employee) / 2 &&
+              isCompressedEmployeeFile(testFilename) &&
+              loadEmployeeRecords(testFilename, loaded, &header) &&
+              header.format == EMPLOYEE_FORMAT_COMPRESSED && header.recordCount == employees.size() &&
+              readEmployeeCompressed(testFilename, direct, NULL, 1) &&
+              loaded.size() == employees.size() && direct.size() == employees.size() &&
+              std::memcmp(&loaded[0], &employees[0], employees.size() * sizeof(Employee)) == 0 &&
+              std::memcmp(&direct[0], &employees[0], employees.size() * sizeof(Employee)) == 0;
+
+    // порча байта блока обнаруживается по контрольной сумме
+    std::string bytes = readWholeFile(testFilename);
+    bytes[sizeof(EmployeeFileHeader) + 100] ^= 1;
+    std::ofstream(testFilename, std::ios::binary).write(bytes.data(), bytes.size());
+    std::vector<Employee> damaged;
+    ok = ok && !loadEmployeeRecords(testFilename, damaged) && damaged.empty();
+
+    std::vector<Employee> none;
+    ok = ok && writeEmployeeCompressed(testFilename, NULL, 0) && loadEmployeeRecords(testFilename, none) &&
+         none.empty();
+    std::remove(testFilename);
+    if (!ok) {
+        std::cerr << "Сжатый файл прочитан неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testEmployeeQuery() {
+    // часы с повторами, чтобы порядок при равной зарплате решал id; одна запись с NaN
+    std::vector<Employee> employees(20000);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>((i * 7919) % employees.size());
+        employees[i].hours = static_cast<double>((i * 31) % 997) / 4;
+    }
+    employees[123].hours = std::numeric_limits<double>::quiet_NaN();
+    const double rate = 2.0;
+
+    std::vector<Employee> expected;
+    for (size_t i = 0; i < employees.size(); i++) {
+        if (i != 123) expected.push_back(employees[i]);
+    }
+    std::sort(expected.begin(), expected.end(), EarnsMore(rate));
+
+    // top по одной записи и целиком, чтобы кандидаты отбирались многократно
+    EmployeeQuery query;
+    query.top = 50;
+    EmployeeSelector selector(query, rate);
+    for (size_t i = 0; i < employees.size(); i++) selector.add(employees[i]);
+    std::vector<Employee> top;
+    selector.finish(top);
+    bool ok = top.size() == 50 && selector.scanned() == employees.size() &&
+              std::memcmp(&top[0], &expected[0], 50 * sizeof(Employee)) == 0;
+
+    // порог по зарплате вместе с порогом по часам; порядок записей сохраняется
+    query.top = 0;
+    query.hasMinHours = true;
+    query.minHours = 100;
+    query.hasMinSalary = true;
+    query.minSalary = 400;
+    EmployeeSelector threshold(query, rate);
+    threshold.add(&employees[0], employees.size());
+    std::vector<Employee> selected, filtered;
+    threshold.finish(selected);
+    for (size_t i = 0; i < employees.size(); i++) {
+        if (employees[i].hours >= 200) filtered.push_back(employees[i]);
+    }
+    ok = ok && !selected.empty() && selected.size() == filtered.size() &&
+         std::memcmp(&selected[0], &filtered[0], filtered.size() * sizeof(Employee)) == 0;
+
+    // top больше числа подходящих записей
+    query.top = 100000;
+    EmployeeSelector all(query, rate);
+    all.add(&employees[0], employees.size());
+    std::vector<Employee> everything;
+    all.finish(everything);
+    std::sort(filtered.begin(), filtered.end(), EarnsMore(rate));
+    ok = ok && everything.size() == filtered.size() &&
+         std::memcmp(&everything[0], &filtered[0], filtered.size() * sizeof(Employee)) == 0;
+    if (!ok) {
+        std::cerr << "Выборка top и порогов неверна." << std::endl;
+    }
+    return ok;
+}
+
+bool testAsyncIO() {
+    std::vector<Employee> employees(5000);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(employees.size() - i);
+        std::sprintf(employees[i].name, "A%u", static_cast<unsigned>(i % 1000));
+        employees[i].hours = i * 0.5;
+    }
+    const char* testFilename = "test_async.bin";
+    const AsyncBackend backends[] = { ASYNC_URING, ASYNC_THREADS, ASYNC_SYNC };
+    bool ok = true;
+    for (int b = 0; b < 3; b++) {
+        std::vector<Employee> loaded;
+        EmployeeFileHeader header;
+        ok = ok && writeEmployeeRecordsAsync(testFilename, employees, backends[b]) &&
+             readEmployeeRecordsAsync(testFilename, loaded, &header, backends[b]) &&
+             header.recordCount == employees.size() && loaded.size() == employees.size() &&
+             std::memcmp(&loaded[0], &employees[0], employees.size() * sizeof(Employee)) == 0;
+
+        // маленькие блоки и неглубокая очередь: ячейки используются повторно, последний блок неполный
+        std::string expected = readWholeFile(testFilename), actual;
+        AsyncFileReader reader;
+        const char* data;
+        size_t size = 1;
+        ok = ok && reader.open(testFilename, backends[b], 1000, 3);
+        while (ok && size > 0) {
+            ok = reader.next(data, size);
+            actual.append(data != NULL ? data : "", size);
+        }
+        ok = ok && actual == expected;
+    }
+
+    // файл без заголовка и поврежденный файл
+    std::ofstream(testFilename, std::ios::binary).write(reinterpret_cast<const char*>(&employees[0]),
+                                                        3 * sizeof(Employee) + 5);
+    std::vector<Employee> legacy;
+    ok = ok && readEmployeeRecordsAsync(testFilename, legacy) && legacy.size() == 3 &&
+         std::memcmp(&legacy[0], &employees[0], 3 * sizeof(Employee)) == 0;
+
+    // записи любой раскладки дописываются в конец непустого вектора
+    const uint16_t formats[] = { EMPLOYEE_FORMAT_NATIVE, EMPLOYEE_FORMAT_PACKED, EMPLOYEE_FORMAT_COLUMNAR,
+                                 EMPLOYEE_FORMAT_COMPRESSED };
+    for (int f = 0; f < 4; f++) {
+        size_t before = legacy.size();
+        ok = ok && (formats[f] == EMPLOYEE_FORMAT_COMPRESSED
+                        ? writeEmployeeCompressed(testFilename, &employees[0], employees.size())
+                        : writeEmployeeRecords(testFilename, employees, formats[f])) &&
+             readEmployeeRecordsAsync(testFilename, legacy) && legacy.size() == before + employees.size() &&
+             legacy[0].num == employees[0].num && legacy[before].num == employees[0].num &&
+             legacy.back().num == employees.back().num;
+    }
+    writeEmployeeRecords(testFilename, employees);
+    std::string bytes = readWholeFile(testFilename);
+    bytes[bytes.size() - 3] ^= 1;
+    std::ofstream(testFilename, std::ios::binary).write(bytes.data(), bytes.size());
+    std::vector<Employee> damaged;
+    ok = ok && !readEmployeeRecordsAsync(testFilename, damaged) && damaged.empty() &&
+         !readEmployeeRecordsAsync("test_async_missing.bin", damaged);
+    std::remove(testFilename);
+    if (!ok) {
+        std::cerr << "Асинхронное чтение или запись работает неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testMergeSortedEmployees() {
+    // три отсортированных массива, один пустой; равные id идут в порядке массивов
+    const int ids[3][4] = { { 1, 4, 4, 9 }, { 0, 0, 0, 0 }, { 2, 4, 9, 10 } };
+    const size_t sizes[3] = { 4, 0, 4 };
+    std::vector<std::vector<Employee> > arrays(3);
+    std::vector<const Employee*> ranges;
+    std::vector<size_t> counts;
+    for (size_t a = 0; a < 3; a++) {
+        for (size_t i = 0; i < sizes[a]; i++) {
+            Employee emp;
+            std::memset(&emp, 0, sizeof(emp));
+            emp.num = ids[a][i];
+            emp.hours = static_cast<double>(a);
+            arrays[a].push_back(emp);
+        }
+        ranges.push_back(arrays[a].empty() ? NULL : &arrays[a][0]);
+        counts.push_back(arrays[a].size());
+    }
+    CollectingWriter writer;
+    bool ok = mergeSortedEmployees(ranges, counts, writer) && writer.records.size() == 8;
+    const int expectedIds[] = { 1, 2, 4, 4, 4, 9, 9, 10 };
+    const double expectedHours[] = { 0, 2, 0, 0, 2, 0, 2, 2 };
+    for (size_t i = 0; ok && i < 8; i++) {
+        ok = writer.records[i].num == expectedIds[i] && writer.records[i].hours == expectedHours[i];
+    }
+
+    // заголовок отчета по нескольким файлам
+    std::vector<const char*> files;
+    files.push_back("a.bin");
+    files.push_back("b.bin");
+    std::ostringstream report;
+    ReportWriter reportWriter(1.0);
+    ok = ok && reportWriter.open(report);
+    reportWriter.writeHeader(files);
+    ok = ok && reportWriter.close() &&
+         report.str() == "Отчет по файлам \"a.bin\", \"b.bin\"\nНомер сотрудника\tИмя сотрудника\tЧасы\tЗарплата\n";
+    if (!ok) {
+        std::cerr << "Слияние отсортированных массивов неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testEmployeeFileReader() {
+    // буфер на 7 записей: файл читается многими порциями, последняя неполная
+    std::vector<Employee> employees(100);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(i * 5 % 101);
+        std::sprintf(employees[i].name, "R%u", static_cast<unsigned>(i));
+        employees[i].hours = i * 1.25;
+    }
+    const char* testFilename = "test_reader.bin";
+    const uint16_t formats[] = { EMPLOYEE_FORMAT_NATIVE, EMPLOYEE_FORMAT_PACKED, EMPLOYEE_FORMAT_COMPRESSED };
+    bool ok = true;
+    for (int f = 0; f < 3; f++) {
+        ok = ok && (formats[f] == EMPLOYEE_FORMAT_COMPRESSED
+                        ? writeEmployeeCompressed(testFilename, &employees[0], employees.size())
+                        : writeEmployeeRecords(testFilename, employees, formats[f]));
+        EmployeeFileReader reader;
+        ok = ok && reader.open(testFilename, 7 * sizeof(Employee)) && reader.header().format == formats[f];
+        size_t i = 0;
+        for (EmployeeFileReader::const_iterator it = reader.begin(); ok && it != reader.end(); ++it, ++i) {
+            ok = i < employees.size() && std::memcmp(&*it, &employees[i], sizeof(Employee)) == 0;
+        }
+        ok = ok && i == employees.size() && reader.ok() && reader.next() == NULL;
+    }
+
+    // файл без заголовка с неполной записью в конце
+    std::ofstream(testFilename, std::ios::binary).write(reinterpret_cast<const char*>(&employees[0]),
+                                                        10 * sizeof(Employee) + 3);
+    EmployeeFileReader legacy(testFilename, 1);
+    size_t count = 0;
+    while (const Employee* emp = legacy.next()) {
+        ok = ok && std::memcmp(emp, &employees[count], sizeof(Employee)) == 0;
+        count++;
+    }
+    ok = ok && count == 10 && legacy.ok() && legacy.header().version == 0;
+
+    // обрезанный и поврежденный файлы обнаруживаются в конце чтения
+    writeEmployeeRecords(testFilename, employees);
+    std::string bytes = readWholeFile(testFilename);
+    std::ofstream(testFilename, std::ios::binary).write(bytes.data(), bytes.size() - sizeof(Employee));
+    EmployeeFileReader truncated(testFilename, 7 * sizeof(Employee));
+    while (truncated.next() != NULL) {}
+    bytes[bytes.size() - 1] ^= 1;
+    std::ofstream(testFilename, std::ios::binary).write(bytes.data(), bytes.size());
+    EmployeeFileReader damaged(testFilename);
+    while (damaged.next() != NULL) {}
+    EmployeeFileReader missing;
+    writeEmployeeRecords(testFilename, employees, EMPLOYEE_FORMAT_COLUMNAR);
+    EmployeeFileReader columnar;
+    ok = ok && !truncated.ok() && !damaged.ok() && !missing.open("test_reader_missing.bin") &&
+         !columnar.open(testFilename);
+    std::remove(testFilename);
+    if (!ok) {
+        std::cerr << "Потоковое чтение файла работает неверно." << std::endl;
+    }
+    return ok;
+}
+
+// каждый писатель дописывает свои id и по одному общему, пачками по 10 записей
+struct ConcurrentAppendState {
+    const char* filename;
+    bool ok[4];
+};
+
+void appendConcurrently(void* arg, size_t index) {
+    ConcurrentAppendState& state = *static_cast<ConcurrentAppendState*>(arg);
+    state.ok[index] = true;
+    for (int batch = 0; batch < 5; batch++) {
+        Employee employees[10];
+        std::memset(employees, 0, sizeof(employees));
+        for (int i = 0; i < 10; i++) {
+            employees[i].num = i == 0 ? -1 - batch : 1000 + static_cast<int>(index) * 100 + batch * 10 + i;
+            std::sprintf(employees[i].name, "W%u", static_cast<unsigned>(index));
+            employees[i].hours = i;
+        }
+        state.ok[index] = appendEmployeeRecords(state.filename, employees, 10) && state.ok[index];
+    }
+}
+
+bool testAppendEmployees() {
+    const char* testFilename = "test_append.bin";
+    std::string indexFilename = employeeIndexFilename(testFilename);
+    std::remove(testFilename);
+    std::remove(indexFilename.c_str());
+
+    // создание файла, дописывание с повтором id внутри пачки и с id из файла
+    std::vector<Employee> employees(6);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(i < 3 ? i : i - 2);
+        employees[i].hours = i * 2.5;
+    }
+    AppendStats stats;
+    bool ok = appendEmployeeRecords(testFilename, &employees[0], 3, true, &stats) &&
+              appendEmployeeRecords(testFilename, &employees[3], 3, true, &stats) &&
+              stats.records == 4 && stats.duplicates == 2 && stats.recovered == 0;
+    std::vector<Employee> loaded;
+    EmployeeFileHeader header;
+    ok = ok && loadEmployeeRecords(testFilename, loaded, &header) && loaded.size() == 4 &&
+         loaded[3].num == 3 && (header.flags & EMPLOYEE_FLAG_SORTED) != 0;
+
+    // несколько писателей одновременно: все пачки целиком, общие id не повторяются
+    ConcurrentAppendState state;
+    state.filename = testFilename;
+    runParallel(4, appendConcurrently, &state);
+    ok = ok && state.ok[0] && state.ok[1] && state.ok[2] && state.ok[3];
+    loaded.clear();
+    ok = ok && loadEmployeeRecords(testFilename, loaded, &header) && loaded.size() == 4 + 5 + 4 * 5 * 9 &&
+         (header.flags & EMPLOYEE_FLAG_SORTED) == 0;
+    EmployeeIdSet ids;
+    for (size_t i = 0; ok && i < loaded.size(); i++) ok = ids.insert(loaded[i].num);
+    // индекс дополнялся участками на месте: каждый участок более чем вдвое
+    // длиннее следующего, каждый id находится ровно один раз
+    EmployeeFileView view;
+    EmployeeIndex index;
+    std::vector<EmployeeIndexEntry> found;
+    ok = ok && view.open(testFilename) && index.open(indexFilename.c_str()) && index.matches(view) &&
+         index.size() == loaded.size();
+    for (size_t r = 1; ok && r < index.runCount(); r++) {
+        ok = index.run(r - 1).second - index.run(r - 1).first > 2 * (index.run(r).second - index.run(r).first);
+    }
+    for (size_t i = 0; ok && i < loaded.size(); i++) {
+        index.find(loaded[i].num, found);
+        ok = found.size() == 1 && employeeIndexRangeMatches(view, found, loaded[i].num, loaded[i].num);
+    }
+    view.close();
+
+    // без uniqueIds индекс и фильтр тоже дополняются: сначала фильтр, построенный
+    // точно по файлу, перестраивается с запасом, затем дополняется на месте
+    std::string bloomFilename = employeeBloomFilename(testFilename);
+    std::vector<Employee> repeated(3);
+    for (size_t i = 0; i < repeated.size(); i++) {
+        std::memset(&repeated[i], 0, sizeof(Employee));
+        repeated[i].num = i == 0 ? 1 : 7000 + static_cast<int>(i);
+    }
+    ok = ok && buildEmployeeBloom(testFilename, bloomFilename.c_str());
+    for (int round = 0; ok && round < 2; round++) {
+        stats = AppendStats();
+        EmployeeBloom bloom;
+        ok = appendEmployeeRecords(testFilename, &repeated[0], repeated.size(), false, &stats) &&
+             stats.records == 3 && stats.duplicates == 0 && view.open(testFilename) &&
+             index.open(indexFilename.c_str()) && index.matches(view) && index.size() == view.size() &&
+             bloom.open(bloomFilename.c_str()) && bloom.matches(view) && bloom.capacity() >= view.size();
+        for (size_t i = 0; ok && i < repeated.size(); i++) {
+            index.find(repeated[i].num, found);
+            ok = found.size() == static_cast<size_t>(i == 0 ? 2 + round : 1) &&
+                 employeeIndexRangeMatches(view, found, repeated[i].num, repeated[i].num) &&
+                 bloom.mayContain(repeated[i].num);
+        }
+        view.close();
+        for (size_t i = 1; i < repeated.size(); i++) repeated[i].num += 100;
+    }
+    // дописанные без проверки id видны следующему дописыванию с проверкой
+    stats = AppendStats();
+    ok = ok && appendEmployeeRecords(testFilename, &repeated[0], 1, true, &stats) && stats.duplicates == 1;
+    index.close();
+
+    // хвост прерванного дописывания отбрасывается следующим
+    std::ofstream(testFilename, std::ios::binary | std::ios::app).write("garbage", 7);
+    Employee extra;
+    std::memset(&extra, 0, sizeof(extra));
+    extra.num = 5000;
+    stats = AppendStats();
+    loaded.clear();
+    ok = ok && appendEmployeeRecords(testFilename, &extra, 1, true, &stats) && stats.recovered == 7 &&
+         loadEmployeeRecords(testFilename, loaded) && loaded.size() == 4 + 5 + 180 + 6 + 1 &&
+         loaded.back().num == 5000;
+
+    // приемник для createEmployees дописывает в файл без заголовка
+    std::ofstream(testFilename, std::ios::binary).write(reinterpret_cast<const char*>(&employees[0]),
+                                                        3 * sizeof(Employee));
+    std::remove(indexFilename.c_str());
+    std::istringstream csv("id,name,hours\n2,Dup,1\n7,New,2\n");
+    EmployeeAppender appender;
+    ImportStats importStats;
+    loaded.clear();
+    ok = ok && appender.open(testFilename) && createEmployees(csv, appender, importStats) && appender.close() &&
+         importStats.records == 1 && importStats.duplicates == 1 &&
+         loadEmployeeRecords(testFilename, loaded, &header) && header.version == 0 && loaded.size() == 4 &&
+         loaded[3].num == 7;
+
+    std::remove(testFilename);
+    std::remove(indexFilename.c_str());
+    std::remove(bloomFilename.c_str());
+    if (!ok) {
+        std::cerr << "Дописывание записей работает неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testNameGroups() {
+    // имена из пяти команд; после '\0' в поле имени может остаться мусор
+    std::vector<Employee> employees(200000);
+    const char* const teams[] = { "alpha", "beta", "", "gamma", "0123456789" };
+    uint64_t counts[5] = { 0, 0, 0, 0, 0 };
+    double hours[5] = { 0, 0, 0, 0, 0 };
+    for (size_t i = 0; i < employees.size(); i++) {
+        size_t team = i * 7 % 5;
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(i);
+        std::memcpy(employees[i].name, teams[team], std::min<size_t>(std::strlen(teams[team]) + 1, 10));
+        if (team == 1) employees[i].name[7] = static_cast<char>('a' + i % 3);
+        employees[i].hours = static_cast<double>(i % 8);
+        counts[team]++;
+        hours[team] += employees[i].hours;
+    }
+    // порядок по имени: "", "0123456789", "alpha", "beta", "gamma"
+    const size_t order[] = { 2, 4, 0, 1, 3 };
+    // запись 1 добавляется повторно поштучно и попадает в ту же группу
+    size_t extra = 1 * 7 % 5;
+    counts[extra]++;
+    hours[extra] += employees[1].hours;
+    bool ok = true;
+    for (unsigned threads = 1; threads <= 4; threads += 3) {
+        NameGroupBuilder builder(threads);
+        builder.add(&employees[0], employees.size());
+        builder.add(employees[1]);
+        std::vector<NameGroup> groups;
+        builder.finish(groups);
+        ok = ok && groups.size() == 5;
+        for (size_t g = 0; ok && g < groups.size(); g++) {
+            size_t team = order[g];
+            ok = std::strcmp(reinterpret_cast<const char*>(groups[g].key.bytes), teams[team]) == 0 &&
+                 groups[g].count == counts[team] && groups[g].hours == hours[team];
+        }
+    }
+
+    // строки отчета по группам
+    NameGroupTable table;
+    NameKey key;
+    makeNameKey(employees[0], key);
+    table.add(key, hashNameKey(key), 2, 7.5);
+    std::vector<NameGroup> groups;
+    table.collect(groups);
+    std::ostringstream report;
+    ReportWriter writer(2.0);
+    std::vector<const char*> files(1, "a.bin");
+    std::string header = formatGroupHeader(files);
+    ok = ok && writer.open(report) && writer.writeBlock(header.data(), header.size()) &&
+         writeNameGroups(writer, groups) && writer.close() &&
+         report.str() == "Итоги по именам, файл \"a.bin\"\nИмя сотрудника\tСотрудников\tЧасы\tЗарплата\n"
+                         "alpha\t2\t7.50\t15.00\n";
+    if (!ok) {
+        std::cerr << "Группировка по имени работает неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testEmployeeBloom() {
+    // четные id есть в файле; из нечетных ложно срабатывает около 1%
+    std::vector<Employee> employees(100000);
+    for (size_t i = 0; i < employees.size(); i++) {
+        std::memset(&employees[i], 0, sizeof(Employee));
+        employees[i].num = static_cast<int>(i * 2);
+    }
+    const char* testFilename = "test_bloom.bin";
+    std::string bloomFilename = employeeBloomFilename(testFilename);
+    const uint16_t formats[] = { EMPLOYEE_FORMAT_NATIVE, EMPLOYEE_FORMAT_PACKED, EMPLOYEE_FORMAT_COLUMNAR,
+                                 EMPLOYEE_FORMAT_COMPRESSED };
+    bool ok = true;
+    for (int f = 0; ok && f < 4; f++) {
+        ok = formats[f] == EMPLOYEE_FORMAT_COMPRESSED
+                 ? writeEmployeeCompressed(testFilename, &employees[0], employees.size())
+                 : writeEmployeeRecords(testFilename, employees, formats[f]);
+        EmployeeFileHeader header;
+        std::ifstream ifs(testFilename, std::ios::binary);
+        ok = ok && readEmployeeFileHeader(ifs, header);
+        ifs.close();
+        EmployeeBloom bloom;
+        ok = ok && buildEmployeeBloom(testFilename, bloomFilename.c_str()) && bloom.open(bloomFilename.c_str()) &&
+             bloom.matches(makeEmployeeFileStamp(header, employees.size(), 0, 0));
+        size_t falsePositives = 0;
+        for (size_t i = 0; ok && i < employees.size(); i++) {
+            ok = bloom.mayContain(employees[i].num);
+            if (bloom.mayContain(employees[i].num + 1)) falsePositives++;
+        }
+        ok = ok && falsePositives < employees.size() / 50;
+    }
+
+    // доля ложных срабатываний на отсутствующих id при BLOOM_BITS_PER_ID битах на id –
+    // и для фильтра из нескольких блоков, где положение битов не должно зависеть от блока
+    const size_t sizes[] = { 60, 400, 5000, 100000 };
+    for (size_t s = 0; ok && s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        EmployeeBloomBuilder builder(sizes[s]);
+        for (size_t i = 0; i < sizes[s]; i++) builder.add(static_cast<int>(i * 7919));
+        EmployeeFileStamp stamp = makeEmployeeFileStamp(makeEmployeeFileHeader(NULL, 0), sizes[s], 0, 0);
+        EmployeeBloom bloom;
+        ok = builder.write(bloomFilename.c_str(), stamp) && bloom.open(bloomFilename.c_str());
+        const size_t probes = 200000;
+        size_t falsePositives = 0;
+        for (size_t i = 0; ok && i < probes; i++) {
+            if (bloom.mayContain(static_cast<int>(i * 7919 + 1))) falsePositives++;
+        }
+        if (ok && falsePositives * 1000 >= probes * 15) {
+            std::cerr << "Ложных срабатываний " << falsePositives * 100.0 / probes << "% для " << sizes[s]
+                      << " id." << std::endl;
+            ok = false;
+        }
+    }
+
+    // после перезаписи файла фильтр устаревает; дописывание его обновляет
+    writeEmployeeRecords(testFilename, employees);
+    EmployeeFileView view;
+    {
+        EmployeeBloom stale;
+        ok = ok && stale.open(bloomFilename.c_str()) && view.open(testFilename) && !stale.matches(view);
+        view.close();
+    }
+    Employee extra;
+    std::memset(&extra, 0, sizeof(extra));
+    extra.num = 1;
+    EmployeeBloom appended;
+    ok = ok && appendEmployeeRecords(testFilename, &extra, 1) && appended.open(bloomFilename.c_str()) &&
+         view.open(testFilename) && appended.matches(view) && appended.mayContain(1) && appended.mayContain(0);
+
+    std::remove(testFilename);
+    std::remove(bloomFilename.c_str());
+    std::remove(employeeIndexFilename(testFilename).c_str());
+    if (!ok) {
+        std::cerr << "Фильтр Блума работает неверно." << std::endl;
+    }
+    return ok;
+}
+
+bool testStageStats() {
+    // замер записи файла самим процессом: байты считаются через /proc/self/io, где он есть
+    StageRecorder recorder(true);
+    std::vector<Employee> employees(10000);
+    std::memset(&employees[0], 0, employees.size() * sizeof(Employee));
+    recorder.begin("write");
+    bool ok = writeEmployeeRecords("test_stage.bin", employees);
+    recorder.end();
+    std::remove("test_stage.bin");
+    StageStats* child = recorder.child("child");
+    ok = ok && recorder.stages().size() == 2 && child == &recorder.stages()[1] && child->child;
+    const StageStats& stage = recorder.stages()[0];
+    uint64_t readBytes, writtenBytes;
+    if (readProcessIo("self", readBytes, writtenBytes)) {
+        ok = ok && stage.writtenBytes != STAGE_UNKNOWN &&
+             stage.writtenBytes >= sizeof(EmployeeFileHeader) + employees.size() * sizeof(Employee);
+    }
+    ok = ok && stage.wallSeconds >= 0 && stage.userSeconds >= 0;
+
+    // выравнивание по буквам UTF-8 и неизвестные счетчики
+    ok = ok && padStageCell("Имя", 5, true) == "Имя  " && padStageCell("ab", 4, false) == "  ab";
+    std::string json = formatStageJson(recorder.stages());
+    ok = ok && json.find("\"name\": \"child\", \"child\": true") != std::string::npos &&
+         json.find("\"read_bytes\": null") != std::string::npos;
+    std::string table = formatStageTable(recorder.stages());
+    ok = ok && table.find("write*") != std::string::npos && table.find("child ") != std::string::npos;
+    if (!ok) {
+        std::cerr << "Замеры стадий работают неверно." << std::endl;
+    }
+    return ok;
+}
+
 int main() {
     int passed = 0, failed = 0;
     std::cout << "Запуск юнит-тестов..." << std::endl;
@@ -86,6 +1457,206 @@ int main() {
         failed++;
     }
 
+    if (testEmployeeFileView()) {
+        std::cout << "testEmployeeFileView пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeFileView провален." << std::endl;
+        failed++;
+    }
+
+    if (testSortAlgorithms()) {
+        std::cout << "testSortAlgorithms пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testSortAlgorithms провален." << std::endl;
+        failed++;
+    }
+
+    if (testExternalSort()) {
+        std::cout << "testExternalSort пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testExternalSort провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeFileHeader()) {
+        std::cout << "testEmployeeFileHeader пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeFileHeader провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeIndex()) {
+        std::cout << "testEmployeeIndex пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeIndex провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeIdSet()) {
+        std::cout << "testEmployeeIdSet пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeIdSet провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeFileWriter()) {
+        std::cout << "testEmployeeFileWriter пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeFileWriter провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeGenerator()) {
+        std::cout << "testEmployeeGenerator пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeGenerator провален." << std::endl;
+        failed++;
+    }
+
+    if (testReportFormat()) {
+        std::cout << "testReportFormat пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testReportFormat провален." << std::endl;
+        failed++;
+    }
+
+    if (testParallelReport()) {
+        std::cout << "testParallelReport пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testParallelReport провален." << std::endl;
+        failed++;
+    }
+
+    if (testPackedFormat()) {
+        std::cout << "testPackedFormat пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testPackedFormat провален." << std::endl;
+        failed++;
+    }
+
+    if (testColumnarFormat()) {
+        std::cout << "testColumnarFormat пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testColumnarFormat провален." << std::endl;
+        failed++;
+    }
+
+    if (testPayrollSummary()) {
+        std::cout << "testPayrollSummary пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testPayrollSummary провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeStream()) {
+        std::cout << "testEmployeeStream пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeStream провален." << std::endl;
+        failed++;
+    }
+
+    if (testPayrollLibrary()) {
+        std::cout << "testPayrollLibrary пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testPayrollLibrary провален." << std::endl;
+        failed++;
+    }
+
+    if (testIncrementalReport()) {
+        std::cout << "testIncrementalReport пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testIncrementalReport провален." << std::endl;
+        failed++;
+    }
+
+    if (testCompressedFormat()) {
+        std::cout << "testCompressedFormat пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testCompressedFormat провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeQuery()) {
+        std::cout << "testEmployeeQuery пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeQuery провален." << std::endl;
+        failed++;
+    }
+
+    if (testAsyncIO()) {
+        std::cout << "testAsyncIO пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testAsyncIO провален." << std::endl;
+        failed++;
+    }
+
+    if (testMergeSortedEmployees()) {
+        std::cout << "testMergeSortedEmployees пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testMergeSortedEmployees провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeFileReader()) {
+        std::cout << "testEmployeeFileReader пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeFileReader провален." << std::endl;
+        failed++;
+    }
+
+    if (testAppendEmployees()) {
+        std::cout << "testAppendEmployees пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testAppendEmployees провален." << std::endl;
+        failed++;
+    }
+
+    if (testNameGroups()) {
+        std::cout << "testNameGroups пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testNameGroups провален." << std::endl;
+        failed++;
+    }
+
+    if (testEmployeeBloom()) {
+        std::cout << "testEmployeeBloom пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testEmployeeBloom провален." << std::endl;
+        failed++;
+    }
+
+    if (testStageStats()) {
+        std::cout << "testStageStats пройден." << std::endl;
+        passed++;
+    } else {
+        std::cout << "testStageStats провален." << std::endl;
+        failed++;
+    }
+
     std::cout << "Тестов пройдено: " << passed << ", провалено: " << failed << std::endl;
     return (failed == 0) ? 0 : 1;
 }
\ No newline at end of file